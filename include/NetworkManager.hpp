@@ -1,10 +1,29 @@
 /**
  * @file NetworkManager.hpp
  * @brief Manages the networking layer using ENet.
+ * Works on Simulation (no raylib dependency), so it links into headless tools.
+ * Packets are encoded with WireProtocol, shared with MatchServer and ShardedServer.
+ * Outgoing messages are coalesced by a PacketBatcher and leave as one packet per
+ * network tick (see Flush).
+ *
+ * Both boards advance one Simulation::Tick per frame. The local board runs as soon
+ * as the player presses a key (StepLocal), and each tick's input is sent stamped
+ * with its frame; the opponent's board is predicted and corrected by rollback
+ * (RollbackSession), so no input ever waits for the network. Inputs travel on
+ * the unreliable channel, each packet repeating the ones not acknowledged yet
+ * (InputChannel); requests, responses and seeds stay reliable.
+ *
+ * Every RollbackSession::CHECKSUM_INTERVAL frames the local board's checksum goes
+ * out with the inputs. When the opponent's copy of our board turns out different,
+ * it asks for our whole board (PACKET_RESYNC_REQ / PACKET_STATE) and continues from it.
  */
 
 #pragma once
-#include "game.hpp"
+#include "simulation.hpp"
+#include "input_channel.hpp"
+#include "packet_batcher.hpp"
+#include "rollback_session.hpp"
+#include "wire_protocol.hpp"
 #include <string>
 
 // Forward declarations for ENet structures to avoid including enet.h in the header
@@ -13,21 +32,6 @@ typedef struct _ENetHost ENetHost;
 struct _ENetPeer;
 typedef struct _ENetPeer ENetPeer;
 
-// Enumeration of all packet types used for communication
-enum PacketType { 
-    PACKET_INPUT,       // Player input state
-    PACKET_SEED,        // RNG Seeds for synchronization
-    PACKET_TICK,        // Gravity tick (Server to Client)
-    PACKET_RESTART_REQ, // Request to restart
-    PACKET_RESTART_RES, // Response to restart
-    PACKET_PAUSE_REQ,   // Request to pause
-    PACKET_PAUSE_RES,   // Response to pause
-    PACKET_RESUME_REQ,  // Request to resume
-    PACKET_RESUME_RES,  // Response to resume
-    PACKET_QUIT,        // Player disconnected/quit
-    PACKET_NEW_GAME     // Force new game sync
-};
-
 // Defines the network role of the application instance
 enum NetworkRole { NONE, SERVER, CLIENT };
 
@@ -42,16 +46,28 @@ public:
     // Initializes an ENet host as a Client and connects to a server.
     bool StartClient(const char* hostName, int port);
     
-    // Main network loop. Polls ENet events and updates game state accordingly.
-    void Update(Game& localGame, Game& remoteGame, bool& isPausedGame, float& countdownTimer, bool useSameSeeds = true);
+    // Main network loop. Polls ENet events and updates game state accordingly, then brings
+    // the remote board up to the local board's frame (predicting the inputs not received yet).
+    void Update(Simulation& localGame, Simulation& remoteGame, bool& isPausedGame, float& countdownTimer, bool useSameSeeds = true);
     
+    // Runs the local board's ticks due after 'elapsedSeconds' (the input is held until a tick consumes
+    // it, as in Simulation::Update) and sends each tick's input stamped with its frame. Nothing runs
+    // while 'stopTimer' is set or before the round's seeds are known. Returns the ticks run.
+    int StepLocal(Simulation& localGame, InputState input, double elapsedSeconds, bool stopTimer);
+
+    // Sends the messages queued since the last network tick, once one is due. Call every frame
+    // after the Send* calls, with the frame time.
+    void Flush(double elapsedSeconds);
+
     // Disconnects peers and destroys the host.
     void Stop();
 
     // Data Transmission Methods ---
-    void SendInput(InputState input);
+    // Adds a local frame's input to the input stream. Inputs with no button pressed are not sent
+    // (the window's frame count covers those frames).
+    void SendInput(uint32_t frame, InputState input);
+    // Sending (host) or receiving (client) the seeds starts a new round at frame 0 on both boards.
     void SendSeed(unsigned int seedHost, unsigned int seedClient);
-    void SendTick();
     void SendRequest(PacketType type);
     void SendResponse(PacketType type, bool accepted);
     void SendQuit();
@@ -66,6 +82,22 @@ public:
     bool resumeRequestPending = false;
     bool opponentQuit = false;
     bool remoteStartedNewGame = false; 
+    bool desyncDetected = false;      // Our copy of the opponent's board diverged (left set for the game to clear)
+
+    // Ask the opponent for its board as soon as a desync is detected (else SendRequest(PACKET_RESYNC_REQ)).
+    bool autoResync = true;
+
+    // Network ticks per second (default PacketBatcher::sendRate).
+    void SetSendRate(int rate) { batcher.sendRate = rate; }
+
+    // Packet, message and byte counters of the outgoing traffic.
+    const PacketBatcher& GetBatcher() const { return batcher; }
+
+    // Prediction and rollback of the remote board (counters included).
+    const RollbackSession& GetRollback() const { return rollback; }
+
+    // Round the boards are in: 0 until the first seeds arrive, then bumped by every PACKET_SEED.
+    uint8_t GetRound() const { return roundStarted ? frames.GetRound() : 0; }
 
     // Retrieves the local machine's IP address (prioritizes private network IPs).
     std::string GetLocalIPInfo(); 
@@ -73,7 +105,36 @@ public:
     NetworkRole role;
     bool isConnected; 
 
+    // Client moving from a server lobby to a match shard (do not retry the lobby meanwhile)
+    bool isRedirecting = false;
+
 private:
+    // Queues one message for the peer (sent by the next Flush)
+    void Send(const NetMessage& message);
+
+    // Frame 0 of a new round, both boards freshly reset
+    void StartRound(uint8_t round);
+
+    // Sends the whole local board (answer to PACKET_RESYNC_REQ), after the queued messages
+    void SendState(const Simulation& localGame);
+
+    // Continues the opponent's board from the state it sent
+    void ApplyState(Simulation& remoteGame, const NetMessage& message);
+
     ENetHost* host;
     ENetPeer* peer;
+    PacketBatcher batcher;
+    PacketBatch outgoing;          // Reliable messages of the next network tick
+
+    // Frame state of the current round
+    RollbackSession rollback;
+    InputChannel frames;           // Local board's stream (and the round number)
+    bool roundStarted = false;
+    uint32_t localFrame = 0;       // Next frame of the local board
+    InputState pendingInput = {};  // Presses not consumed by a local tick yet
+
+    // Server the client connected to, and the match slot to claim after a redirect
+    std::string serverHost;
+    uint16_t redirectPort = 0;
+    uint64_t joinToken = 0;
 };
\ No newline at end of file
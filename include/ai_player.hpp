@@ -0,0 +1,120 @@
+/**
+ * @file ai_player.hpp
+ * @brief Definition of the AIPlayer class.
+ * Computer opponent that plays a Simulation through the same InputState a human
+ * produces. Each new piece triggers a decision: a beam search over the reachable
+ * placements (PlacementEnumerator) of the current piece, nextBlock and further
+ * queued pieces, scored by a tunable board heuristic. Beam expansion is split
+ * across worker threads, which share a transposition table of board evaluations
+ * (boards are Zobrist-hashed, see Zobrist), and boards reached through different
+ * move orders are kept once per beam. The workers start with the player and wait
+ * between search levels, so a decision never creates a thread. The chosen
+ * placement is then reached one move per tick.
+ * Headless, so it also drives load-generating clients and batch runs.
+ */
+
+#pragma once
+#include "simulation.hpp"
+#include "placement_enumerator.hpp"
+#include "transposition_table.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Heuristic weights (positive = good). Defaults are a well-known tuned set for
+// the four classic features.
+struct AIWeights {
+    double aggregateHeight = -0.510066;   // Sum of the column heights
+    double linesCleared = 0.760666;       // Lines cleared along the searched sequence
+    double holes = -0.35663;              // Empty cells with a filled cell above them
+    double bumpiness = -0.184483;         // Sum of height differences between neighbouring columns
+};
+
+class AIPlayer {
+public:
+    // lookahead: pieces searched after the current one (1 = nextBlock, more use the bag preview).
+    // beamWidth: boards kept per search level. numThreads: 0 = one per hardware thread.
+    AIPlayer(int lookahead = 2, int beamWidth = 32, int numThreads = 0);
+    ~AIPlayer();
+
+    // Chooses the input for the next tick of 'game'.
+    InputState GetInput(const Simulation& game);
+
+    // Drops the current plan and the cached evaluations (call when the game is reset
+    // or after changing 'weights').
+    void Reset();
+
+    // Heuristic value of a board (raw row masks), without the lines term.
+    static double EvaluateBoard(const uint16_t* rows, const AIWeights& weights);
+
+    // Duration of the last decision (beam search), in milliseconds.
+    double GetLastDecisionMs() const { return lastDecisionMs; }
+
+    // Evaluation cache shared by the search threads (hit-rate counters included).
+    const TranspositionTable& GetEvalCache() const { return evalCache; }
+
+    AIWeights weights;
+
+    // Minimum ticks between two moves (0 = a move every tick). Slows the bot to a human pace.
+    int ticksPerMove = 0;
+
+private:
+    // A board in the beam
+    struct Node {
+        uint16_t rows[Grid::NUM_ROWS];
+        uint64_t hash;             // Zobrist::Rows of 'rows'
+        double score;
+        int lines;
+        int16_t firstPlacement;    // Placement of the current piece this board descends from
+    };
+
+    // Runs the beam search for the current piece and stores the chosen target
+    bool Decide(const Simulation& game);
+
+    // Locks piece 'id' at 'placement' on top of 'parent' and scores the result
+    void MakeChild(const Node& parent, int id, const Placement& placement, Node& child, uint64_t& hits);
+
+    // Expands nodes [begin, end) with piece 'id' into 'out' (one enumerator per worker)
+    void Expand(const std::vector<Node>& nodes, size_t begin, size_t end, int id,
+                PlacementEnumerator& enumerator, std::vector<Node>& out);
+
+    // Keeps the best beamWidth distinct boards of 'nodes'
+    void KeepBest(std::vector<Node>& nodes) const;
+
+    // Expands the beam with piece 'id' into workerOutput, split over 'workers' threads (this one included)
+    void ExpandLevel(int id, int workers);
+
+    // Loop of search worker 'w' (1 to numThreads - 1): expands its share of every level handed out
+    void WorkerLoop(int w);
+
+    int lookahead;
+    int beamWidth;
+    int numThreads;
+
+    // Search buffers, reused between decisions
+    std::vector<std::unique_ptr<PlacementEnumerator>> enumerators;
+    std::vector<std::vector<Node>> workerOutput;
+    std::vector<Node> beam;
+    TranspositionTable evalCache;
+
+    // Search workers, parked between levels (worker 0 is the thread calling GetInput)
+    std::vector<std::thread> workers;
+    std::mutex workLock;
+    std::condition_variable workReady, workDone;
+    uint64_t workGeneration;       // Bumped for every level handed out
+    int workPiece;                 // Piece and beam share of the current level
+    int workCount;
+    size_t workShare;
+    int workPending;               // Workers still expanding the current level
+    bool stopping;
+
+    // Current plan: target lock position, and the grid it was decided on
+    bool hasTarget;
+    int targetRotation, targetRow, targetColumn;
+    uint16_t decidedRows[Grid::NUM_ROWS];
+    uint64_t lastMoveTick;
+    double lastDecisionMs;
+};
@@ -0,0 +1,93 @@
+/**
+ * @file batch_simulation.hpp
+ * @brief Definition of the BatchSimulation class.
+ * Steps many boards in lockstep for bot training and self-play.
+ * Board state is stored as structure-of-arrays (one contiguous array per field)
+ * instead of one Simulation object per board, so a step over 10k+ boards walks
+ * a few dense arrays. Collision, line clears and scoring reuse the exact rules
+ * of Grid and Simulation (row-mask kernels and scoring helpers).
+ */
+
+#pragma once
+#include "simulation.hpp"
+#include <cstdint>
+#include <vector>
+
+// Action applied to a single board for one step
+enum BatchAction : uint8_t {
+    ACTION_NONE,
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_ROTATE,
+    ACTION_SOFT_DROP,
+    ACTION_HARD_DROP
+};
+
+class BatchSimulation {
+public:
+    // Allocates state for a fixed number of boards and resets them all (board i uses seed + i).
+    BatchSimulation(int numBoards, uint32_t seed = 0);
+
+    // Resets every board. Board i is seeded with seed + i.
+    void Reset(uint32_t seed);
+
+    // Resets a single board (e.g., after it reached game over).
+    void ResetBoard(int board, uint32_t seed);
+
+    // Applies actions[i] to board i, followed by one gravity step, for every board.
+    // Boards that are already over are skipped. Returns the number of boards that were stepped.
+    int StepBatch(const BatchAction* actions);
+
+    // Average board-steps per second over every StepBatch call so far.
+    double GetStepsPerSecond() const;
+
+    // --- Read-only Board State ---
+    int GetNumBoards() const { return numBoards; }
+    const uint16_t* GetRows(int board) const { return &rows[board * Grid::NUM_ROWS]; }
+    int GetPiece(int board) const { return pieceId[board]; }
+    int GetNextPiece(int board) const { return nextPieceId[board]; }
+    int GetScore(int board) const { return score[board]; }
+    int GetLevel(int board) const { return level[board]; }
+    int GetLinesCleared(int board) const { return totalLinesCleared[board]; }
+    bool IsGameOver(int board) const { return gameOver[board] != 0; }
+
+private:
+    // Applies one action and one gravity step to a board.
+    void StepBoard(int board, BatchAction action);
+
+    // Moves the current piece one row down, locking it if blocked. Returns true if it moved.
+    bool MoveDown(int board);
+
+    // Writes the current piece into the rows, spawns the next one, clears lines and scores.
+    void LockPiece(int board);
+
+    // Places a new piece of the given type at its spawn position.
+    void SpawnPiece(int board, int id);
+
+    bool Fits(int board, int rotation, int row, int column) const;
+
+    int numBoards;
+
+    // --- Structure-of-Arrays Board State ---
+    std::vector<uint16_t> rows;            // numBoards * NUM_ROWS bitboard rows
+    std::vector<uint8_t> pieceId;
+    std::vector<uint8_t> pieceRotation;
+    std::vector<int8_t> pieceRow;
+    std::vector<int8_t> pieceColumn;
+    std::vector<uint8_t> nextPieceId;
+    std::vector<int32_t> score;
+    std::vector<int32_t> level;
+    std::vector<int32_t> totalLinesCleared;
+    std::vector<uint8_t> gameOver;
+
+    // Per-board 7-bag generator (same generator as Simulation, so equal seeds give equal pieces)
+    std::vector<PieceBag> bags;
+
+    // Spawn position for each piece ID (taken from the Block subclasses)
+    int8_t spawnRow[8];
+    int8_t spawnColumn[8];
+
+    // Throughput counters
+    uint64_t totalSteps;
+    double totalSeconds;
+};
\ No newline at end of file
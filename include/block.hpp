@@ -1,35 +1,46 @@
 /**
  * @file block.hpp
  * @brief Definition of the base Block class.
- * Represents a Tetris piece (Tetromino), handling its shape, rotation, 
- * movement, and rendering.
+ * Represents a Tetris piece (Tetromino), handling its shape, rotation 
+ * and movement. Rendering is done by Game (no raylib dependency here).
  */
 
 #pragma once
-#include <vector>
-#include <map>
+#include <array>
+#include <cstdint>
 #include "position.hpp"
-#include "colors.hpp"
 
 class Block {
 public:
     Block();
 
-    // unique identifier for the block type (determines color)
+    // unique identifier for the block type (determines color and shape)
     int id; 
 
-    // Stores the block's shape for each of the 4 rotation states (0, 90, 180, 270 degrees)
-    // Key: Rotation state (0-3), Value: List of cell positions relative to the block's pivot
-    std::map<int, std::vector<Position>> cells; 
+    // Number of rotation states stored for every piece (0, 90, 180, 270 degrees)
+    static constexpr int NUM_ROTATIONS = 4;
 
-    // Renders the block on the screen.
-    void Draw(int offsetX, int offsetY, int dynamicCellSize, Color tint = {0, 0, 0, 0});   
-    
     // Updates the block's position in the grid.
     void Move(int rows, int columns);
     
     // Returns the absolute grid positions of the block's cells based on current rotation and offset.
-    std::vector<Position> GetCellPositions();
+    std::array<Position, 4> GetCellPositions() const;
+
+    // Returns the 4 cell positions of a piece, relative to its pivot, for a given rotation state.
+    static const std::array<Position, 4>& GetShape(int id, int rotation);
+
+    // Returns the shape as 4 row masks (bit N of entry R set when local cell (R, N) is filled).
+    // Used by Grid for collision tests without materializing cell positions.
+    static const std::array<uint8_t, 4>& GetRowMasks(int id, int rotation);
+
+    // Returns, for each local column (0-3), the lowest local row filled by the shape (-1 if the column is empty).
+    // Used by Grid to compute landing rows from the column occupancy summary.
+    static const std::array<int8_t, 4>& GetColumnBottoms(int id, int rotation);
+
+    // Current placement (read-only)
+    int GetRotation() const { return rotationState; }
+    int GetRow() const { return rowOffset; }
+    int GetColumn() const { return columnOffset; }
     
     // Rotates the block 90 degrees clockwise.
     void Rotate();
@@ -37,13 +48,8 @@ public:
     // Reverts the last rotation (used when a rotation causes a collision).
     void UndoRotation();
 
-    // Currently unused, potential leftover for storing previous state
-    std::vector<Position> movedTiles;
-
 private:
-    int cellSize; 
     int rotationState; 
-    std::vector<Color> colors;
     int rowOffset;
     int columnOffset;
 };
\ No newline at end of file
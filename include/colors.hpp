@@ -20,4 +20,7 @@ extern const Color lightBlue;
 extern const Color darkBlue;
 
 // Returns a vector containing the color palette for the blocks
-std::vector<Color> GetCellColors();
\ No newline at end of file
+std::vector<Color> GetCellColors();
+
+// Returns the palette color for a single Block ID (no allocation, safe to call per cell)
+Color GetCellColor(int id);
\ No newline at end of file
@@ -1,13 +1,18 @@
 /**
  * @file grid.hpp
  * @brief Definition of the Grid class.
- * Represents the Tetris playfield, handling cell states, row clearing,
- * and rendering of the game board.
+ * Represents the Tetris playfield, handling cell states, collisions and row clearing.
+ * Part of the headless simulation core: no raylib dependency (Game draws the board).
+ *
+ * The board is stored as a bitboard: one 16-bit occupancy mask per row, with
+ * the side walls baked into the mask so that collision and full-row checks
+ * are plain mask compares. Block colors live in a separate packed plane
+ * (3 bits per cell) that is only read for rendering. A Zobrist hash of the
+ * occupancy is maintained alongside (see Zobrist) for search caches.
  */
 
 #pragma once
-#include <vector>
-#include "raylib.h"
+#include <cstdint>
 
 class Grid {
 public:
@@ -19,9 +24,6 @@ public:
     // Prints the grid state to the console (debug purposes).
     void Print();
 
-    //Renders the grid on the screen.
-    void Drawn(int offsetX, int offsetY, int dynamicCellSize);
-
     // Checks if specific coordinates are outside the grid boundaries.
     bool IsCellOutside(int row, int column);
 
@@ -32,22 +34,78 @@ public:
     // Scan for full rows, clears them, moves blocks down, and returns the count of cleared rows.
     int ClearFullRows();
 
-    // The actual 2D array representing the game board (20 rows x 10 columns).
-    // 0 = Empty, 1-7 = Color IDs of blocks.
-    int grid[20][10];
+    // Combined "outside or occupied" test for a candidate placement of a piece.
+    // Returns true if every cell of piece 'id' in the given rotation, offset by (row, column),
+    // lies inside the grid and on an empty cell. Works on the row masks directly (no allocation).
+    bool PieceFits(int id, int rotation, int row, int column) const;
+
+    // Returns how many rows a piece can fall straight down from a valid placement before it lands.
+    // Uses the per-column occupancy summary, so the cost does not depend on the drop height.
+    int GetDropDistance(int id, int rotation, int row, int column) const;
+
+    // Height of the stack in a column (0 = empty, 20 = filled up to the top row).
+    int GetColumnHeight(int column) const;
+
+    // Returns the color ID stored in a cell (0 = Empty, 1-7 = Color IDs of blocks).
+    int GetCell(int row, int column) const;
+
+    // Stores a color ID in a cell and updates the occupancy mask (0 clears the cell).
+    void SetCell(int row, int column, int id);
+
+    // Returns the occupancy mask of a row, walls included (see ColumnBit).
+    uint16_t GetRowMask(int row) const { return rows[row]; }
+
+    // All NUM_ROWS row masks, for the row-mask kernels below.
+    const uint16_t* GetRows() const { return rows; }
+
+    // Zobrist hash of the occupancy (equal to Zobrist::Rows over GetRows). 0 for an empty grid.
+    uint64_t GetHash() const { return hash; }
+
+    // --- Row-Mask Kernels ---
+    // Operate on a raw array of NUM_ROWS row masks so other board layouts
+    // (e.g., BatchSimulation's structure-of-arrays) share the exact same rules.
+
+    // PieceFits on a raw row-mask array.
+    static bool PieceFitsRows(const uint16_t* rows, int id, int rotation, int row, int column);
+
+    // Removes full rows, shifts the rows above them down and refills the top with empty rows.
+    // 'colors' (one packed color row per mask, may be nullptr) is compacted alongside.
+    // Returns a bitmask of the cleared row indices (as they were before compaction).
+    static uint32_t ClearFullRowMasks(uint16_t* rows, uint32_t* colors);
+
+    // Returns a bitmask of the rows equal to FULL_ROW (bit r = row r), checking all rows at once
+    // with SSE2/AVX2 compares when available.
+    static uint32_t FindFullRows(const uint16_t* rows);
+
+    // Bit of the row mask that represents a given column.
+    static constexpr int ColumnBit(int column) { return column + WALL_BITS; }
+
+    // --- Board Dimensions ---
+    static constexpr int NUM_ROWS = 20;
+    static constexpr int NUM_COLUMNS = 10;
+
+    // --- Bitboard Layout ---
+    static constexpr int WALL_BITS = 3;                    // Solid wall bits on each side of the row
+    static constexpr uint16_t FULL_ROW = 0xFFFF;           // Every column (and both walls) occupied
+    static constexpr uint16_t EMPTY_ROW = 0xE007;          // Only the walls occupied
 
 private:
-    // Helper to check if a single row is completely filled.
-    bool IsRowFull(int row);
+    // Returns the first occupied row at or below 'row' in a column (numRows if none).
+    int NextOccupiedRow(int column, int row) const;
+
+    static constexpr int numRows = NUM_ROWS;
+    static constexpr int numColums = NUM_COLUMNS;
+
+    // Occupancy bitboard (20 rows), bit ColumnBit(c) set when column c is filled.
+    uint16_t rows[numRows];
 
-    // Helper to clear a single row (set all cells to 0).
-    void ClearRow(int row);
+    // Packed color plane: 3 bits per cell, column c stored at bits [3c, 3c + 2].
+    uint32_t cellColors[numRows];
 
-    // Helper to move a row down by a specific number of steps.
-    void MoveRowDown(int row, int numRows);
+    // Column occupancy summary (transposed bitboard): bit r of columnMasks[c] set when (r, c) is filled.
+    // Kept in sync by SetCell and ClearFullRows; heights and landing rows are bit scans over it.
+    uint32_t columnMasks[numColums];
 
-    int numRows;
-    int numColums;
-    int cellSize;
-    std::vector<Color> colors;
+    // Zobrist hash of 'rows', updated by SetCell (one key per cell) and ClearFullRows (rows that move).
+    uint64_t hash;
 };
\ No newline at end of file
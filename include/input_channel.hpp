@@ -0,0 +1,73 @@
+/**
+ * @file input_channel.hpp
+ * @brief Definition of the InputChannel class.
+ * Sending side of one board's frame stream (its per-frame inputs and sampled
+ * checksums) over ENet's unreliable, sequenced CHANNEL_FRAMES. Nothing is ever
+ * resent on its own: every network tick carries one PACKET_INPUT window listing
+ * all the inputs of the frames the receiver has not acknowledged yet, so a lost
+ * packet costs one network tick instead of stalling the inputs behind it until
+ * a reliable resend (head-of-line blocking). The receiver acknowledges with the
+ * 'ack' field of its own windows.
+ *
+ * Tetris input is sparse (idle frames are not listed), so a window stays small:
+ * a handful of inputs per round trip. Windows never skip a frame; past
+ * MAX_WINDOW_INPUTS the window simply ends earlier and the rest follows.
+ */
+
+#pragma once
+#include "packet_batcher.hpp"
+#include "wire_protocol.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+class InputChannel {
+public:
+    // Most recent sampled checksums kept for resending while the receiver lags behind.
+    static constexpr size_t MAX_PENDING_CHECKSUMS = 4;
+
+    InputChannel();
+
+    // New round: nothing sent or acknowledged yet. Messages of other rounds are ignored.
+    void Reset(uint8_t round);
+    uint8_t GetRound() const { return round; }
+
+    // --- Stream ---
+
+    // Input of a frame of the stream (idle inputs are skipped), in frame order.
+    void AddInput(uint32_t frame, InputState input);
+
+    // Every frame before 'frames' is part of the stream (idle unless added).
+    void SetFrameCount(uint32_t frames);
+
+    // Checksum of the board before 'frame' (see RollbackSession::CHECKSUM_INTERVAL).
+    void AddChecksum(uint32_t frame, uint64_t checksum);
+
+    // --- Network ---
+
+    // A PACKET_INPUT window of the receiver's own stream arrived. 'ack' is how far that stream
+    // is confirmed now (after applying the window).
+    void OnWindow(const NetMessage& window, uint32_t ack);
+
+    // Queues this network tick's messages into 'batch' (checksums the receiver may still need,
+    // then the input window, carrying 'ack'). Returns false, queueing nothing, when the receiver
+    // already has the whole stream and knows 'ack'.
+    bool Queue(PacketBatcher& batcher, ENetPeer* peer, PacketBatch& batch, uint32_t ack);
+
+    // Frames of the stream the receiver acknowledged.
+    uint32_t GetAckedFrame() const { return ackedFrame; }
+
+private:
+    struct FrameChecksum {
+        uint32_t frame;
+        uint64_t checksum;
+    };
+
+    std::deque<FrameInput> inputs;             // Inputs of the frames not acknowledged yet
+    std::deque<FrameChecksum> checksums;
+    uint32_t frameCount;
+    uint32_t ackedFrame;
+    uint32_t sentAck;                          // Last ack sent for the receiver's stream
+    bool ackDue;                               // The receiver did not get our last ack
+    uint8_t round;
+};
@@ -13,14 +13,16 @@ public:
     /**
      * Handle key presses with DAS (Delayed Auto Shift).
      * Allows a key to be pressed once for a single action, or held down to repeat the action.
+     * 'now' is the player's simulation clock time (SimClock::GetTime), so the delay and the
+     * repeat rate are measured in fixed ticks rather than wall-clock time.
      * True if the action should trigger this frame, False otherwise.
      */
-    static bool HandleKeyWithDAS(int key1, int key2, int playerIdx, int timerIdx, float interval, bool inputBlocked);
+    static bool HandleKeyWithDAS(int key1, int key2, int playerIdx, int timerIdx, float interval, bool inputBlocked, double now);
 
 private:
     // Initial delay before auto-repeat starts (in seconds)
     static float dasDelay;
     
     // Matrix to track DAS timers: [Player Index][Action Index]
-    static float timers[2][3]; 
+    static double timers[2][3]; 
 };
\ No newline at end of file
@@ -0,0 +1,200 @@
+/**
+ * @file match_server.hpp
+ * @brief Definition of the MatchServer class.
+ * Headless dedicated server: accepts game clients over ENet, pairs them into
+ * matches as they connect and hosts any number of matches in one process. For
+ * each match it plays the role the hosting player has in a peer-to-peer game:
+ * it picks the seeds (PACKET_SEED) and relays the frame-stamped inputs, requests
+ * and responses between the two players. Both boards are also simulated on the
+ * server, frame by frame as each player confirms them (a RollbackSession that
+ * never predicts), so it always holds the authoritative state of every match.
+ * Clients connect with "Join Game" and need no changes. No raylib, window or GPU.
+ * The server's boards are the reference: it checks the players' sampled
+ * checksums against them, and a copy that diverged is replaced with the server's
+ * board (PACKET_STATE), whether a player asks for it (PACKET_RESYNC_REQ, answered
+ * by the server instead of relayed) or the server finds a player's own board
+ * differs, in which case the opponent's copy of it is corrected. A PACKET_STATE
+ * sent by a player is ignored.
+ *
+ * Messages to a player are coalesced per network tick (PacketBatcher). Inputs are
+ * relayed over the unreliable channel like between two players: the server
+ * acknowledges each player's stream and keeps resending the opponent's inputs
+ * a player has not acknowledged yet (InputChannel).
+ *
+ * Spectators connect with CONNECT_SPECTATOR and subscribe to a match with
+ * PACKET_WATCH. They get the round's seeds and the confirmed inputs of both boards
+ * (PACKET_WATCH_FRAMES) and simulate the match themselves (see Spectator). The
+ * stream is the same for every spectator of a match, so each network tick it is
+ * encoded once and broadcast as one shared packet (PacketBatcher::Broadcast).
+ * Spectators joining mid-match get both whole boards (PACKET_WATCH_STATE) at the
+ * stream's current frame.
+ *
+ * A player left waiting alone for botWaitSeconds gets a server bot as opponent:
+ * an AIPlayer plays the second board on the server, one input per frame in real
+ * time, and its frames go out exactly like a player's (input windows and sampled
+ * checksums). The server answers the player's requests on the bot's behalf.
+ *
+ * A MatchServer is single-threaded. ShardedServer runs several of them, one per
+ * thread and port, and hands them pre-paired matches as MatchTickets instead.
+ */
+
+#pragma once
+#include "NetworkManager.hpp"
+#include "ai_player.hpp"
+#include "input_channel.hpp"
+#include "packet_batcher.hpp"
+#include "rollback_session.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// A match reserved by a lobby: the two players claim their slots with PACKET_JOIN.
+// A second token of 0 reserves a match against a server bot.
+struct MatchTicket {
+    uint64_t tokens[2];
+};
+
+class MatchServer {
+public:
+    MatchServer();
+    ~MatchServer();
+
+    // Opens the ENet host on 'port', accepting up to 'maxClients' connections (two per match).
+    bool Start(int port, int maxClients = 256);
+
+    // Tells every player the server is going away and closes the host.
+    void Stop();
+
+    // Handles the pending network events (waiting up to 'waitMs' for the first one), brings every
+    // board to the frame its player confirmed, and counts 'elapsedSeconds' for tickets and sends.
+    void Update(double elapsedSeconds, uint32_t waitMs = 0);
+
+    bool IsRunning() const { return host != nullptr; }
+    size_t GetMatchCount() const { return matches.size(); }
+    bool HasWaitingPlayer() const { return waiting != nullptr; }
+
+    // Spectators subscribed to a match (all matches).
+    size_t GetSpectatorCount() const;
+
+    // Frames simulated on the authoritative boards since Start (all matches).
+    uint64_t GetFramesSimulated() const { return framesSimulated; }
+
+    // Network ticks per second: how often the queued messages of each player are sent.
+    void SetSendRate(int rate) { batcher.sendRate = rate; }
+
+    // Packet, message and byte counters of the outgoing traffic (all players).
+    const PacketBatcher& GetBatcher() const { return batcher; }
+
+    // Reserves a match for two players who will join with the ticket's tokens.
+    // Unclaimed reservations expire after TICKET_TIMEOUT seconds.
+    void AddTicket(const MatchTicket& ticket);
+    size_t GetPendingTicketCount() const { return tickets.size(); }
+
+    // Both players get the same piece sequence (same as the host's "SEEDS: EQUAL").
+    bool useSameSeeds = true;
+
+    // Pair players in connection order. When false, players only enter matches through tickets.
+    bool pairOnConnect = true;
+
+    // Seconds a player paired on connect waits for an opponent before a server bot takes the
+    // other side (negative: never).
+    double botWaitSeconds = 10.0;
+
+    static constexpr double TICKET_TIMEOUT = 10.0;
+
+    // The bot plays the second slot and waits out the countdown players run after seeds and resumes
+    static constexpr int BOT_SLOT = 1;
+    static constexpr double BOT_COUNTDOWN = 3.5;
+
+private:
+    struct Match {
+        ENetPeer* players[2];    // players[BOT_SLOT] is nullptr in a match against the bot
+        Simulation games[2];     // Authoritative boards, indexed like 'players'
+        RollbackSession sessions[2];
+        InputChannel streams[2]; // Opponent's frames relayed to each player
+        PacketBatch outbox[2];   // Reliable messages queued for each player until the next network tick
+        uint8_t round = 0;
+        unsigned int seeds[2];   // Seeds of the current round
+        uint64_t id = 0;
+
+        // Spectator stream, shared by every spectator
+        std::vector<ENetPeer*> spectators;
+        std::vector<ENetPeer*> joiningSpectators;  // Get both boards at the next network tick
+        std::vector<FrameInput> watchInputs[2];    // Confirmed inputs not broadcast yet
+        uint32_t watchedFrames[2] = { 0, 0 };      // Frames broadcast so far
+        PacketBatch watchBatch;
+
+        // Server bot playing games[BOT_SLOT] (no second player)
+        std::unique_ptr<AIPlayer> bot;
+        double botCountdown = 0;
+        bool botPaused = false;
+    };
+
+    // Pairs two connected players (a server bot when 'second' is nullptr) and starts their first round
+    void StartMatch(ENetPeer* first, ENetPeer* second);
+
+    // Plays the bot's frames due after 'elapsedSeconds' and feeds them to the player's stream
+    void StepBot(Match& match, double elapsedSeconds);
+
+    // Answers a request of the player facing the bot, as the bot's client would
+    void AnswerForBot(Match& match, const NetMessage& message);
+
+    // Picks new seeds, resets both boards and sends each player its seeds
+    void StartRound(Match& match);
+
+    // Runs the frames both players confirmed since the last call
+    void StepMatch(Match& match);
+
+    // Applies and relays the messages of a packet sent by 'peer'
+    void HandlePacket(ENetPeer* peer, const uint8_t* data, size_t size);
+    void HandleMessage(ENetPeer* peer, const NetMessage& message);
+
+    // Sends the server's board 'board' to the player in slot 'to', whose copy of it diverged
+    void SendBoard(Match& match, int board, int to);
+
+    // Player 'peer' left: tells the opponent and removes the match
+    void EndMatch(ENetPeer* peer);
+
+    // Claims a ticket slot for 'peer'; starts the match once both players are in
+    void JoinTicket(ENetPeer* peer, uint64_t token);
+
+    // Expires old tickets and forgets disconnected players ('gone', may be nullptr)
+    void UpdateTickets(double elapsedSeconds, const ENetPeer* gone);
+
+    // Subscribes 'peer' to match 'matchId' (0 = the oldest running match)
+    void Watch(ENetPeer* peer, uint64_t matchId);
+
+    // Returns the slot (0 or 1) of 'peer' in its match, -1 for a spectator
+    static int GetSlot(const Match& match, const ENetPeer* peer);
+
+    // Queues a message for a player in a match, sends it right away to anyone else
+    void Send(ENetPeer* peer, const NetMessage& message);
+
+    // Sends the queued messages and the input windows of both players of 'match'
+    void FlushMatch(Match& match);
+
+    // Broadcasts the frames confirmed since the last network tick to the spectators of 'match',
+    // and both boards to the spectators who joined since (after StepMatch: boards at their confirmed frame)
+    void FlushSpectators(Match& match);
+
+    // Tells the spectators of 'match' it is over and lets them go
+    void ReleaseSpectators(Match& match);
+
+    ENetHost* host;
+    PacketBatcher batcher;
+    ENetPeer* waiting;                          // Connected player without an opponent yet
+    double waitingTime;                         // Seconds it has been waiting
+    std::vector<std::unique_ptr<Match>> matches;
+
+    struct PendingTicket {
+        MatchTicket ticket;
+        ENetPeer* players[2];    // Players that already claimed their slot
+        double age;
+    };
+    std::vector<PendingTicket> tickets;
+
+    uint32_t seedCounter;
+    uint64_t nextMatchId;
+    uint64_t framesSimulated;
+};
@@ -0,0 +1,103 @@
+/**
+ * @file network_shim.hpp
+ * @brief Definition of the NetworkShim class.
+ * Impairs a real network path on one machine: a UDP relay on the loopback
+ * interface that sits between an ENet client and its server and makes every
+ * datagram suffer a configurable link (LinkProfile): delay, jitter, loss,
+ * duplication and reordering, separately per direction. The client connects to
+ * the shim's port instead of the server's; nothing else changes, so the whole
+ * ENet stack (acks, resends, RTT estimates) sees the bad network as it would
+ * over the Internet. Built on ENet's socket API, single-threaded: Update moves
+ * the datagrams and must be called often (every millisecond or so). Reproducible
+ * for a given seed and traffic. Used by tools/net_bench.cpp.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+// Conditions of one direction of the link
+struct LinkProfile {
+    double delayMs = 0;       // One-way delay
+    double jitterMs = 0;      // Random extra delay, 0 to jitterMs (datagrams keep their order)
+    double loss = 0;          // Probability a datagram is dropped (0-1)
+    double duplicate = 0;     // Probability a datagram is delivered twice
+    double reorder = 0;       // Probability a datagram is held back 'reorderMs', letting later ones pass
+    double reorderMs = 20;
+};
+
+// Counters of one direction
+struct LinkStats {
+    uint64_t packets = 0;     // Datagrams received from the sender
+    uint64_t bytes = 0;       // Their UDP payload (ENet headers included)
+    uint64_t dropped = 0;
+    uint64_t duplicated = 0;
+    uint64_t reordered = 0;
+};
+
+enum LinkDirection {
+    LINK_TO_SERVER,
+    LINK_TO_CLIENT
+};
+
+class NetworkShim {
+public:
+    NetworkShim();
+    ~NetworkShim();
+
+    // Listens on 127.0.0.1:'listenPort' and relays to 'serverHost':'serverPort'. The first peer
+    // to send to the listening port is the client. 'seed' drives the impairment decisions.
+    bool Start(int listenPort, const char* serverHost, int serverPort, uint32_t seed = 1);
+
+    // Closes both sockets; datagrams still held back are lost.
+    void Stop();
+
+    // Reads the datagrams that arrived, applying the link's profile, and delivers the due ones.
+    void Update();
+
+    LinkProfile& GetProfile(LinkDirection direction) { return links[direction].profile; }
+    const LinkStats& GetStats(LinkDirection direction) const { return links[direction].stats; }
+
+    bool IsRunning() const { return running; }
+
+private:
+    struct Datagram {
+        uint64_t due;                 // Microseconds (steady clock)
+        uint64_t order;               // Ties keep the arrival order
+        std::vector<uint8_t> data;
+        bool operator>(const Datagram& other) const {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    struct Link {
+        LinkProfile profile;
+        LinkStats stats;
+        std::priority_queue<Datagram, std::vector<Datagram>, std::greater<Datagram>> pending;
+        uint64_t lastDue = 0;         // Jittered datagrams never overtake the previous one
+    };
+
+    // Applies the profile of 'link' to a datagram received now
+    void Schedule(Link& link, const uint8_t* data, size_t size, uint64_t now);
+
+    // Sends the due datagrams of 'link' from 'socket' to 'host':'port'
+    void Deliver(Link& link, intptr_t socket, uint32_t host, uint16_t port, uint64_t now);
+
+    static uint64_t NowMicros();
+
+    // ENetSockets (an int or a SOCKET) and addresses, kept opaque: no enet.h in the header
+    intptr_t listenSocket;            // Client side
+    intptr_t serverSocket;            // Server side (ephemeral port)
+    uint32_t clientHost, serverHost;
+    uint16_t clientPort, serverPort;
+    bool hasClient;
+    bool running;
+
+    Link links[2];
+    uint64_t arrivals;
+    std::mt19937 rng;
+};
@@ -0,0 +1,118 @@
+/**
+ * @file packet_batcher.hpp
+ * @brief Definition of the PacketBatcher class.
+ * Coalesces outgoing WireProtocol messages: instead of one ENet packet per
+ * message, each destination gets a PacketBatch the messages are appended to,
+ * and the batch leaves as a single packet once per network tick (or earlier if
+ * it fills up). Messages are self-delimiting, so the receiver walks the packet
+ * with WireProtocol::DecodeNext.
+ *
+ * Control messages travel reliably and in order on CHANNEL_CONTROL. The frame
+ * stream (inputs, checksums) uses CHANNEL_FRAMES, unreliable and sequenced: a
+ * lost packet is not resent and never holds back the ones behind it, since each
+ * input window repeats everything the peer has not acknowledged (InputChannel).
+ *
+ * A batch can also be broadcast: its packet is built once and the same ENetPacket
+ * is queued on every peer of a list (ENet counts the references), so the cost of
+ * a message stream hardly depends on how many peers follow it (spectators).
+ *
+ * Packet payloads come from a pool of fixed-size buffers handed to ENet without
+ * a copy (ENET_PACKET_FLAG_NO_ALLOCATE); ENet gives a buffer back through the
+ * packet's free callback once the packet is acknowledged, so steady-state sends
+ * never allocate a payload. A batcher is single-threaded and must outlive every
+ * host its packets were sent on.
+ */
+
+#pragma once
+#include "wire_protocol.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Forward declarations for ENet structures to avoid including enet.h in the header
+struct _ENetPeer;
+typedef struct _ENetPeer ENetPeer;
+struct _ENetPacket;
+typedef struct _ENetPacket ENetPacket;
+
+// ENet channels of every host (NetworkManager, MatchServer, ShardedServer)
+enum NetChannel {
+    CHANNEL_CONTROL,    // Reliable, ordered
+    CHANNEL_FRAMES,     // Unreliable, sequenced (older packets arriving late are dropped)
+    CHANNEL_COUNT
+};
+
+// Messages waiting for one destination
+struct PacketBatch {
+    uint8_t* buffer = nullptr;    // Pool buffer, only held while messages are pending
+    size_t length = 0;
+    uint32_t messages = 0;
+};
+
+class PacketBatcher {
+public:
+    // Payload capacity of one packet (well under a UDP MTU: no ENet fragmentation).
+    static constexpr size_t BUFFER_SIZE = 256;
+
+    PacketBatcher();
+
+    // Appends a message to 'batch'. A full batch is sent to 'peer' (on 'channel') first.
+    void Queue(ENetPeer* peer, PacketBatch& batch, const NetMessage& message, NetChannel channel = CHANNEL_CONTROL);
+
+    // Sends the pending messages of 'batch' to 'peer' as one packet (nothing if empty).
+    void Send(ENetPeer* peer, PacketBatch& batch, NetChannel channel = CHANNEL_CONTROL);
+
+    // Sends a single message right away (still from a pooled buffer).
+    void SendNow(ENetPeer* peer, const NetMessage& message);
+
+    // Sends an encoded message too large for a pool buffer (PACKET_STATE) as a packet of its own,
+    // after the pending messages of 'batch' so the peer still receives everything in order.
+    void SendLarge(ENetPeer* peer, PacketBatch& batch, const std::vector<uint8_t>& message);
+
+    // Broadcast versions of Queue, Send and SendLarge: every peer of 'peers' gets the same packet,
+    // reliable and in order on CHANNEL_CONTROL, built once whatever the number of peers.
+    void QueueBroadcast(const std::vector<ENetPeer*>& peers, PacketBatch& batch, const NetMessage& message);
+    void Broadcast(const std::vector<ENetPeer*>& peers, PacketBatch& batch);
+    void BroadcastLarge(const std::vector<ENetPeer*>& peers, PacketBatch& batch, const std::vector<uint8_t>& message);
+
+    // Drops the pending messages of 'batch' (its destination is gone).
+    void Discard(PacketBatch& batch);
+
+    // Counts real time and returns true when a network tick is due (one per 1 / sendRate seconds).
+    bool IsTickDue(double elapsedSeconds);
+
+    // Network ticks per second. Lower rates mean fewer, larger packets and more latency.
+    int sendRate = 30;
+
+    // Totals since construction. A broadcast counts once per peer (the traffic it causes),
+    // except in GetPacketsBuilt.
+    uint64_t GetPacketsSent() const { return packetsSent; }
+    uint64_t GetPacketsBuilt() const { return packetsBuilt; }
+    uint64_t GetMessagesSent() const { return messagesSent; }
+    uint64_t GetBytesSent() const { return bytesSent; }
+
+    // Buffers allocated by the pool (grows only while more packets are in flight than ever before).
+    size_t GetPoolSize() const { return storage.size(); }
+
+private:
+    uint8_t* Acquire();
+
+    // ENet free callback: returns the payload to the pool of the batcher in packet->userData
+    static void Release(ENetPacket* packet);
+
+    // Builds the packet of the pending messages of 'batch' (empties it); nullptr if there are none
+    ENetPacket* Build(PacketBatch& batch, NetChannel channel);
+
+    // Queues 'packet' on every peer of 'peers' (destroyed right away if no peer took it)
+    void Deliver(ENetPacket* packet, ENetPeer* const* peers, size_t count, NetChannel channel, uint32_t messages);
+
+    std::vector<std::unique_ptr<uint8_t[]>> storage;
+    std::vector<uint8_t*> freeBuffers;
+    double tickTimer;
+
+    uint64_t packetsSent;
+    uint64_t packetsBuilt;
+    uint64_t messagesSent;
+    uint64_t bytesSent;
+};
@@ -0,0 +1,50 @@
+/**
+ * @file piece_bag.hpp
+ * @brief Definition of the PieceBag class.
+ * Compact, seedable 7-bag piece generator. State is a PCG32 random generator
+ * (8 bytes), the remaining pieces of the current bag as a 7-bit mask and a small
+ * preview queue, 32 bytes in total. The same seed always produces the same
+ * sequence, which keeps network seed synchronization (PACKET_SEED) working.
+ */
+
+#pragma once
+#include <cstdint>
+
+class PieceBag {
+public:
+    // Number of upcoming pieces that can be previewed (two full bags).
+    static constexpr int MAX_PREVIEW = 14;
+
+    PieceBag();
+
+    // Restarts the generator. The sequence depends only on the seed.
+    void Reset(uint32_t seed);
+
+    // Returns the next piece ID (1-7) and removes it from the queue.
+    int Next();
+
+    // Returns the piece that the (index + 1)-th call to Next would return, without consuming it.
+    // index must be below MAX_PREVIEW.
+    int Peek(int index);
+
+    // Hash of the generator state. Two bags that will deal the same pieces hash the same,
+    // however much of the sequence each one has already drawn ahead into its preview queue.
+    uint64_t GetChecksum() const;
+
+private:
+    // Replay keyframes save and restore the generator state
+    friend class ReplayWriter;
+    friend class ReplayReader;
+
+    // PCG32 (XSH RR) step
+    uint32_t NextRandom();
+
+    // Draws a uniformly random piece from the bag mask, refilling it when empty.
+    int DrawFromBag();
+
+    uint64_t rngState;
+    uint8_t bagMask;          // Bit N set = piece ID N+1 still in the current bag
+    uint8_t queueHead;
+    uint8_t queueCount;
+    uint8_t queue[16];        // Ring buffer of drawn but not yet consumed pieces
+};
\ No newline at end of file
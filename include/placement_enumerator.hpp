@@ -0,0 +1,99 @@
+/**
+ * @file placement_enumerator.hpp
+ * @brief Definition of the PlacementEnumerator class.
+ * Finds every lock position a piece can reach from its current placement using
+ * the real movement rules (left, right, clockwise rotation without kicks, down),
+ * for AI players and hints.
+ *
+ * The reachable set is a search over (rotation, row, column) states kept as
+ * bitsets: one 32-bit row mask per (rotation, column) for "the piece fits here"
+ * and one for "visited". Each step expands a whole column of rows at once (a
+ * drop is a single carry-propagating add), so enumerating costs a few hundred
+ * word operations. Lock positions that cover the same cells through a symmetric
+ * rotation (O, I, S, Z) are reported once. The move sequence to a chosen result
+ * comes from a breadth-first search with parent links, run only on request.
+ * All buffers live inside the object, so nothing allocates.
+ */
+
+#pragma once
+#include "grid.hpp"
+#include "block.hpp"
+#include <cstdint>
+
+// One move of a path from the start placement (see PlacementEnumerator::GetPath)
+enum PlacementMove : uint8_t {
+    PLACEMENT_LEFT,
+    PLACEMENT_RIGHT,
+    PLACEMENT_ROTATE,
+    PLACEMENT_DOWN
+};
+
+// A reachable lock position: the block placement in which moving down no longer fits
+struct Placement {
+    int8_t rotation;
+    int8_t row;
+    int8_t column;
+};
+
+class PlacementEnumerator {
+public:
+    // Range of block offsets covered by the state space (every placement that fits lies inside it)
+    static constexpr int ROW_MIN = -3;
+    static constexpr int ROW_SPAN = Grid::NUM_ROWS - ROW_MIN;
+    static constexpr int COLUMN_MIN = -3;
+    static constexpr int COLUMN_SPAN = 16;
+    static constexpr int ROW_STRIDE = 32;      // ROW_SPAN rounded up, so states decode with shifts
+    static constexpr int NUM_STATES = Block::NUM_ROTATIONS * ROW_STRIDE * COLUMN_SPAN;
+
+    // Upper bound on the results of one call (one lock per row, rotation and column)
+    static constexpr int MAX_PLACEMENTS = Block::NUM_ROTATIONS * Grid::NUM_ROWS * COLUMN_SPAN;
+
+    PlacementEnumerator();
+
+    // Enumerates the lock positions reachable by 'block' on 'grid'. Returns their count
+    // (0 if the block does not fit where it is).
+    int Enumerate(const Grid& grid, const Block& block);
+
+    // Same on a raw array of Grid::NUM_ROWS row masks (e.g., a BatchSimulation board).
+    int Enumerate(const uint16_t* rows, int id, int rotation, int row, int column);
+
+    int GetCount() const { return count; }
+    const Placement& GetPlacement(int index) const { return placements[index]; }
+    const Placement* GetPlacements() const { return placements; }
+
+    // Writes a shortest sequence of moves from the start placement to a result (at most maxMoves,
+    // the final lock not included) and returns its length. The rows given to the last Enumerate
+    // must not have changed.
+    int GetPath(int index, PlacementMove* out, int maxMoves);
+
+private:
+    static int StateIndex(int rotation, int row, int column) {
+        return (rotation * ROW_STRIDE + (row - ROW_MIN)) * COLUMN_SPAN + (column - COLUMN_MIN);
+    }
+
+    // Row mask of the offsets where the piece fits, for one rotation and column (0 outside the state space)
+    uint32_t GetFitRows(int rotation, int column);
+
+    // Whether the piece fits at (rotation, row, column), from the fit masks
+    bool Fits(int rotation, int row, int column);
+
+    // Search input
+    const uint16_t* rows;
+    int pieceId;
+    int startRotation, startRow, startColumn;
+
+    // Bit (row - ROW_MIN) of fitRows[rotation][column - COLUMN_MIN] set when the piece fits there.
+    // Built on first use; fitReady has one bit per (rotation, column).
+    uint32_t fitRows[Block::NUM_ROTATIONS][COLUMN_SPAN];
+    uint64_t fitReady;
+
+    // Path search state (only entries of visited states are meaningful)
+    uint64_t visited[NUM_STATES / 64];
+    uint16_t queue[NUM_STATES];
+    uint16_t parent[NUM_STATES];
+    uint8_t parentMove[NUM_STATES];
+
+    // Results
+    Placement placements[MAX_PLACEMENTS];
+    int count;
+};
@@ -2,7 +2,7 @@
 
 class Position{ //Defines the Variables and Constructors of The class B
     public:
-    Position(int row, int column);
+    constexpr Position(int row, int column) : row(row), column(column) {}
     int row;
     int column;
 
@@ -0,0 +1,139 @@
+/**
+ * @file replay.hpp
+ * @brief Definition of the ReplayWriter and ReplayReader classes.
+ * Compact binary game recordings: the seed followed by the per-tick input and
+ * gravity stream consumed by Simulation::Tick, plus periodic keyframes (full
+ * state snapshots) for seeking.
+ *
+ * Layout (all multi-byte fields little-endian):
+ *   Header (16 bytes): "TRPL", version (u16), keyframe interval in ticks (u16), seed (u32), reserved (u32)
+ *   Records, each starting with a varint tag:
+ *     tag & 0x7F != 0 : (tag >> 7) idle ticks, then one tick with input mask (tag & 0x7F)
+ *     tag & 0x7F == 0 : (tag >> 7) idle ticks (tag > 0)
+ *     tag == 0        : keyframe (state after the tick it names), see replay.cpp
+ * Idle ticks (no input, no gravity step) are run-length encoded, so a game costs
+ * roughly one or two bytes per key press and gravity step. Records are only ever
+ * appended, so a file being written is always a valid, playable prefix.
+ */
+
+#pragma once
+#include "simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Bits of a recorded tick (input mask)
+enum ReplayInputBits : uint8_t {
+    REPLAY_LEFT      = 1 << 0,
+    REPLAY_RIGHT     = 1 << 1,
+    REPLAY_DOWN      = 1 << 2,
+    REPLAY_ROTATE    = 1 << 3,
+    REPLAY_HARD_DROP = 1 << 4,
+    REPLAY_RESET     = 1 << 5,
+    REPLAY_GRAVITY   = 1 << 6   // Gravity stepped the block this tick
+};
+
+class ReplayWriter {
+public:
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+
+    // keyframeInterval: ticks between two keyframes (600 = every 10 seconds of play).
+    ReplayWriter(int keyframeInterval = 600);
+
+    // Starts a new recording of 'game' (call right after game.Reset) and attaches
+    // itself as the game's recorder. Writes the header and the tick 0 keyframe.
+    void Begin(Simulation& game);
+
+    // Appends one tick (called by Simulation::Tick while recording).
+    void RecordTick(const Simulation& game, InputState input, bool gravity);
+
+    // Writes the pending idle ticks so the data covers every recorded tick.
+    void Finish();
+
+    // Writes the bytes not yet flushed to 'out' (streaming to a file while the game runs).
+    void Flush(std::ostream& out);
+
+    const std::vector<uint8_t>& GetData() const { return data; }
+
+    // Packs the buttons of an InputState into replay input bits.
+    static uint8_t EncodeInput(InputState input);
+
+    // Appends the keyframe encoding of 'state' (everything but the seed) to 'out'.
+    // Also carries whole boards over the network (PACKET_STATE).
+    static void EncodeSnapshot(const Snapshot& state, std::vector<uint8_t>& out);
+
+private:
+    void WriteKeyframe(const Simulation& game);
+    void WriteIdle();
+
+    std::vector<uint8_t> data;
+    size_t flushed;
+    uint32_t idleTicks;
+    int keyframeInterval;
+};
+
+class ReplayReader {
+public:
+    ReplayReader();
+
+    // Parses the header and indexes the keyframes. The data is not copied and must outlive the reader.
+    // Returns false if the header is missing or has an unknown version.
+    bool Open(const uint8_t* data, size_t size);
+
+    uint32_t GetSeed() const { return seed; }
+    int GetKeyframeInterval() const { return keyframeInterval; }
+
+    // Last tick covered by the recording.
+    uint64_t GetLength() const { return length; }
+
+    // Tick of the game being played back.
+    uint64_t GetTick() const { return tick; }
+
+    // Restarts 'game' at tick 0 of the recording.
+    bool Start(Simulation& game);
+
+    // Plays the next recorded tick. Returns false at the end of the recording.
+    bool Step(Simulation& game);
+
+    // Puts 'game' at the state after 'targetTick': restores the closest keyframe
+    // at or before it, then plays the remaining ticks. Returns false if out of range.
+    bool Seek(Simulation& game, uint64_t targetTick);
+
+    // Plays every remaining tick and returns how many were played.
+    uint64_t PlayToEnd(Simulation& game);
+
+    // Same as InputState fields, decoded from replay input bits.
+    static InputState DecodeInput(uint8_t bits);
+
+    // Decodes an EncodeSnapshot body at 'pos' into 'state' (or only validates and skips it if state
+    // is nullptr) and moves 'pos' past it. The seed is left untouched. Returns false if malformed.
+    static bool DecodeSnapshot(const uint8_t* data, size_t size, size_t& pos, Snapshot* state, uint64_t& tick);
+
+private:
+    struct Keyframe {
+        uint64_t tick;
+        size_t offset;    // Offset of the keyframe body (after its tag)
+    };
+
+    // Reads the next varint tag; false at the end (or on a truncated record).
+    bool ReadTag(size_t& pos, uint64_t& tag) const;
+
+    // Decodes a keyframe body at 'pos' into 'state' (or only skips it if state is nullptr).
+    bool ReadKeyframe(size_t& pos, Snapshot* state, uint64_t& keyframeTick) const;
+
+    const uint8_t* data;
+    size_t size;
+    uint32_t seed;
+    int keyframeInterval;
+    uint64_t length;
+    std::vector<Keyframe> keyframes;
+
+    // Playback cursor
+    size_t pos;
+    uint64_t tick;
+    uint64_t pendingIdle;
+    uint8_t pendingBits;
+    bool hasPendingTick;
+};
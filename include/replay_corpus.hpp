@@ -0,0 +1,100 @@
+/**
+ * @file replay_corpus.hpp
+ * @brief Definition of the ReplayCorpusWriter and ReplayCorpus classes.
+ * Archive of many replays in one memory-mappable file. A fixed-size index entry
+ * per game (seed, final score, level, lines and the location of its replay data)
+ * lets queries scan millions of games straight from the mapping, without
+ * parsing or copying a single replay.
+ *
+ * Layout (little-endian, read in place on little-endian hosts):
+ *   Header (32 bytes): "TRPC", version (u16), entry size (u16), game count (u32),
+ *                      reserved (u32), index offset (u64), reserved (u64)
+ *   Replay data: the games' replay files (see replay.hpp), back to back
+ *   Index: game count CorpusEntry records, 8-byte aligned
+ * The index is written last, so games are streamed to disk as they are added.
+ */
+
+#pragma once
+#include "replay.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Index record of one game
+struct CorpusEntry {
+    uint64_t offset;        // Start of the replay data in the file
+    uint32_t size;          // Replay data size in bytes
+    uint32_t seed;
+    uint32_t score;         // Final state of the game
+    uint16_t level;
+    uint16_t reserved;
+    uint32_t linesCleared;
+    uint32_t ticks;         // Replay length
+};
+static_assert(sizeof(CorpusEntry) == 32, "CorpusEntry is a file format record");
+
+// Range filter for ReplayCorpus::Query (bounds are inclusive)
+struct CorpusQuery {
+    int minLevel = 0, maxLevel = INT32_MAX;
+    int minScore = 0, maxScore = INT32_MAX;
+    int minLines = 0, maxLines = INT32_MAX;
+};
+
+class ReplayCorpusWriter {
+public:
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32;
+
+    ~ReplayCorpusWriter();
+
+    // Creates the corpus file. Returns false if it cannot be written.
+    bool Open(const std::string& path);
+
+    // Appends a replay. Its final state is found by playing it back headless.
+    // Returns false if the data is not a valid replay.
+    bool Add(const uint8_t* replay, size_t size);
+
+    // Writes the index and the final header. Called by the destructor if needed.
+    bool Close();
+
+    size_t GetCount() const { return entries.size(); }
+
+private:
+    std::ofstream file;
+    std::vector<CorpusEntry> entries;
+    uint64_t offset = 0;
+};
+
+class ReplayCorpus {
+public:
+    ReplayCorpus();
+    ~ReplayCorpus();
+
+    // Maps the corpus file read-only and validates its header and index.
+    bool Open(const std::string& path);
+    void Close();
+
+    size_t GetCount() const { return count; }
+
+    // The index, directly in the mapped file.
+    const CorpusEntry* GetEntries() const { return entries; }
+    const CorpusEntry& GetEntry(size_t index) const { return entries[index]; }
+
+    // Indices of the games matching every range of the query.
+    std::vector<uint32_t> Query(const CorpusQuery& query) const;
+
+    // Points 'reader' at the replay data of a game (no copy) for playback in a Simulation.
+    bool OpenReplay(size_t index, ReplayReader& reader) const;
+
+private:
+    const uint8_t* base;
+    size_t size;
+    const CorpusEntry* entries;
+    size_t count;
+
+    // Platform mapping handles
+    void* fileHandle;
+    void* mappingHandle;
+};
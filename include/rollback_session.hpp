@@ -0,0 +1,119 @@
+/**
+ * @file rollback_session.hpp
+ * @brief Definition of the RollbackSession class.
+ * Runs the opponent's board of an online match without waiting for the network
+ * (GGPO-style rollback). Both peers advance their boards one Simulation::Tick
+ * per frame, so a board is a pure function of its seed and its per-frame inputs,
+ * and every input travels stamped with its frame. Frames whose input has not
+ * arrived yet are predicted; when the real input turns out different, the board
+ * is restored from the snapshot taken before that frame and re-simulated.
+ *
+ * Tetris input is sparse, so the prediction is "no button pressed" (repeating
+ * the last input, as GGPO does, would repeat a rotation or a hard drop). Snapshots
+ * are kept in a ring of MAX_ROLLBACK_FRAMES entries, which also bounds how far the
+ * board may run ahead of the last confirmed frame and so the cost of a rollback.
+ * Headless, also used by MatchServer to run its authoritative boards (no prediction).
+ *
+ * Desync detection: every CHECKSUM_INTERVAL frames the board's owner sends the
+ * Simulation::GetChecksum of its own board (PACKET_CHECKSUM). The session takes
+ * the same checksum when its copy reaches that frame and compares the two once
+ * the frame is confirmed, i.e. once no rollback can change it any more.
+ */
+
+#pragma once
+#include "simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+struct RollbackStats {
+    uint64_t rollbacks = 0;            // Mispredictions that restored a snapshot
+    uint64_t resimulatedFrames = 0;    // Frames simulated again after a rollback
+    uint64_t predictedFrames = 0;      // Frames simulated before their input was known
+    uint32_t maxDepth = 0;             // Deepest rollback, in frames
+    uint64_t checksumsVerified = 0;    // Sampled checksums that matched the owner's
+    uint64_t desyncs = 0;              // Sampled checksums that did not
+};
+
+class RollbackSession {
+public:
+    // Snapshot ring size: the board never runs more frames ahead of the confirmed frame.
+    static constexpr uint32_t MAX_ROLLBACK_FRAMES = 32;
+
+    // Frames between two sampled checksums (half a second at 60 Hz).
+    static constexpr uint32_t CHECKSUM_INTERVAL = 30;
+
+    // Confirmed inputs kept after they were simulated, so that a PACKET_STATE overtaken by newer
+    // inputs (it travels on the reliable channel, inputs on the unreliable one) can still be used.
+    static constexpr uint32_t RESYNC_HISTORY_FRAMES = 240;
+
+    RollbackSession();
+
+    // Starts a new round (call right after resetting the board): frame 0, no input received.
+    void Start();
+
+    // A remote input, stamped with the frame it was applied on. Inputs arrive in frame order
+    // and idle frames are not sent, so it also confirms every frame up to and including 'frame'.
+    // Returns false for an input already known (frame confirmed before).
+    bool AddInput(uint32_t frame, InputState input);
+
+    // The remote simulated every frame before 'frame'.
+    void Confirm(uint32_t frame);
+
+    // The owner's checksum of its board before 'frame' (sent for every multiple of CHECKSUM_INTERVAL).
+    void AddChecksum(uint32_t frame, uint64_t checksum);
+
+    // Corrects 'board' if a prediction turned out wrong, runs the frames confirmed since the last
+    // call, then predicts up to 'targetFrame' (usually the local board's frame; 0 = no prediction).
+    // Returns true if this call found the board out of sync with its owner's; checksums are
+    // then no longer compared until Resync.
+    bool Advance(Simulation& board, uint32_t targetFrame);
+
+    // The owner's state before 'frame' (PACKET_STATE) is about to be restored on the board: continue
+    // from there, simulating again the frames confirmed since. Returns false, changing nothing, if
+    // the state is older than the kept input history (RESYNC_HISTORY_FRAMES).
+    bool Resync(uint32_t frame);
+
+    // A sampled checksum differed and no Resync happened since.
+    bool IsDesynced() const { return desynced; }
+    uint32_t GetDesyncFrame() const { return desyncFrame; }
+
+    // Next frame 'board' will simulate, and the first frame whose input is still unknown.
+    uint32_t GetFrame() const { return frame; }
+    uint32_t GetConfirmedFrame() const { return confirmedFrame; }
+
+    const RollbackStats& GetStats() const { return stats; }
+    void ResetStats() { stats = RollbackStats(); }
+
+private:
+    struct FrameChecksum {
+        uint32_t frame;
+        uint64_t checksum;
+    };
+
+    // A simulated frame that may still be rolled back: the state before it and the input used
+    struct FrameState {
+        Snapshot state;
+        InputState input;
+    };
+
+    // Real input of 'frame' (idle when none was sent). 'cursor' walks 'inputs' in frame order.
+    InputState GetInput(uint32_t frame, size_t& cursor) const;
+
+    // Simulates one frame, keeping a snapshot if it is not confirmed yet
+    void Step(Simulation& board, InputState input);
+
+    // Compares the checksums of the frames that became final. Returns true on a mismatch.
+    bool VerifyChecksums();
+
+    FrameState ring[MAX_ROLLBACK_FRAMES];
+    std::deque<FrameInput> inputs;     // Received inputs, simulated ones kept for RESYNC_HISTORY_FRAMES
+    uint32_t frame;
+    uint32_t confirmedFrame;
+    uint32_t predictedFrom;            // First frame simulated with a predicted input
+    std::deque<FrameChecksum> checksums;        // Taken on 'board', not compared yet
+    std::deque<FrameChecksum> remoteChecksums;  // Received from the owner, not compared yet
+    bool desynced;
+    uint32_t desyncFrame;
+    RollbackStats stats;
+};
@@ -0,0 +1,88 @@
+/**
+ * @file sharded_server.hpp
+ * @brief Definition of the ShardedServer class.
+ * Multi-threaded front for MatchServer. A lobby on the public port pairs players
+ * in connection order and sends each pair to the least loaded shard: a worker
+ * thread running its own MatchServer (own ENet host) on port + 1 + shard index.
+ * The pairing is handed to the shard as a MatchTicket through a lock-free
+ * single-producer/single-consumer queue, and both players receive a
+ * PACKET_REDIRECT with the shard's port and their join token. Shards never share
+ * state, so matches scale with the number of threads. A player nobody joins
+ * within botWaitSeconds is sent alone, to play the shard's server bot.
+ */
+
+#pragma once
+#include "match_server.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+class ShardedServer {
+public:
+    ShardedServer();
+    ~ShardedServer();
+
+    // Opens the lobby on 'port' and starts 'numShards' worker threads (0 = one per hardware
+    // thread) on the following ports, each accepting 'clientsPerShard' connections.
+    bool Start(int port, int numShards = 0, int clientsPerShard = 1024);
+
+    // Stops the shards (their players are told the server quit) and closes the lobby.
+    void Stop();
+
+    // Runs the lobby: pairs new players and hands the matches to the shards.
+    // Waits up to 'waitMs' for the first network event.
+    void Update(uint32_t waitMs = 0);
+
+    size_t GetShardCount() const { return shards.size(); }
+
+    // Totals over all shards (read from their counters, may lag by one pass).
+    // Matches include the ones reserved but not yet joined.
+    size_t GetMatchCount() const;
+    uint64_t GetFramesSimulated() const;
+    uint64_t GetPacketsSent() const;
+    size_t GetSpectatorCount() const;
+
+    bool HasWaitingPlayer() const { return waiting != nullptr; }
+
+    // Applied to every shard at Start.
+    bool useSameSeeds = true;
+    int sendRate = 30;             // Network ticks per second (see MatchServer::SetSendRate)
+
+    // Seconds a player waits in the lobby before playing a server bot (negative: never).
+    double botWaitSeconds = 10.0;
+
+private:
+    static constexpr size_t TICKET_QUEUE_SIZE = 1024;
+
+    struct Shard {
+        int port;
+        MatchServer server;
+        SpscQueue<MatchTicket, TICKET_QUEUE_SIZE> tickets;   // Lobby -> shard
+        std::atomic<int> load{0};             // Matches running or reserved on the shard
+        std::atomic<uint64_t> framesSimulated{0};
+        std::atomic<uint64_t> packetsSent{0};
+        std::atomic<size_t> spectators{0};
+        std::thread thread;
+    };
+
+    // Worker loop of one shard
+    void RunShard(Shard& shard);
+
+    // Sends a paired match (against the bot when 'second' is nullptr) to the least loaded shard;
+    // false if every queue is full
+    bool Dispatch(ENetPeer* first, ENetPeer* second);
+
+    // Encodes and sends one reliable message from the lobby
+    void Send(ENetPeer* peer, const NetMessage& message);
+
+    ENetHost* lobby;
+    ENetPeer* waiting;
+    std::chrono::steady_clock::time_point waitingSince;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<bool> running;
+    std::mt19937_64 tokenGenerator;
+};
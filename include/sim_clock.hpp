@@ -0,0 +1,44 @@
+/**
+ * @file sim_clock.hpp
+ * @brief Definition of the SimClock class.
+ * Fixed-timestep clock: converts variable real frame times into a whole number
+ * of simulation ticks through an accumulator. Every game instance owns its own
+ * clock, so the rules only ever see ticks and a game replays identically from
+ * its seed and per-tick inputs, whatever the frame rate was.
+ */
+
+#pragma once
+#include <cstdint>
+
+class SimClock {
+public:
+    // Simulation rate (ticks per second) and the duration of one tick.
+    static constexpr int TICK_RATE = 60;
+    static constexpr double TICK_SECONDS = 1.0 / TICK_RATE;
+
+    SimClock();
+
+    // Adds real elapsed time (scaled by timeScale) and returns how many ticks are now due.
+    // At most maxCatchUpTicks are returned per call; time beyond that is dropped so a long
+    // stall (window drag, breakpoint) does not fast-forward the game.
+    int Advance(double elapsedSeconds);
+
+    // Drops the partially accumulated tick (pause, countdown) so resuming never drops a burst of rows.
+    void Reset();
+
+    // Total number of ticks produced since construction.
+    uint64_t GetTicks() const { return ticks; }
+
+    // Clock time in seconds (GetTicks() / TICK_RATE). Only advances while ticks are produced.
+    double GetTime() const { return ticks * TICK_SECONDS; }
+
+    // Speed multiplier applied to real time (1 = real time, higher for faster-than-real-time runs).
+    double timeScale;
+
+    // Upper bound on the ticks returned by a single Advance call.
+    int maxCatchUpTicks;
+
+private:
+    double accumulator;
+    uint64_t ticks;
+};
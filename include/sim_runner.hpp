@@ -0,0 +1,74 @@
+/**
+ * @file sim_runner.hpp
+ * @brief Definition of the SimRunner class.
+ * Plays large numbers of independent headless games (different seeds and bot
+ * policies) across all CPU cores using a work-stealing scheduler, and aggregates
+ * the score, level and cleared-lines distributions.
+ */
+
+#pragma once
+#include "simulation.hpp"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// A bot policy chooses the input for the next frame (fixed simulation tick) of a game.
+// 'rngState' is a per-game random state the policy may use (seeded from the job seed).
+typedef InputState (*BotPolicy)(const Simulation& game, uint64_t& rngState);
+
+// One game to play: RNG seed for Simulation::Reset and index of the policy (see SimRunner::AddPolicy)
+struct SimJob {
+    uint32_t seed;
+    int policy;
+};
+
+// Histogram of integer results (exact value counts) with summary statistics.
+class Distribution {
+public:
+    void Add(int value);
+    void Merge(const Distribution& other);
+
+    uint64_t Count() const { return count; }
+    int Min() const { return count ? counts.begin()->first : 0; }
+    int Max() const { return count ? counts.rbegin()->first : 0; }
+    double Mean() const { return count ? sum / count : 0.0; }
+
+    // Smallest value such that at least 'fraction' (0-1) of the samples are <= value.
+    int Percentile(double fraction) const;
+
+private:
+    std::map<int, uint64_t> counts;
+    uint64_t count = 0;
+    double sum = 0;
+};
+
+// Aggregated output of SimRunner::Run
+struct RunnerResults {
+    uint64_t gamesPlayed = 0;
+    uint64_t framesSimulated = 0;
+    double seconds = 0;
+    Distribution score;
+    Distribution level;
+    Distribution linesCleared;
+};
+
+class SimRunner {
+public:
+    // Uses one worker thread per hardware thread when numThreads is 0.
+    SimRunner(int numThreads = 0);
+
+    // Registers a bot policy and returns its index for SimJob::policy.
+    int AddPolicy(BotPolicy policy);
+
+    // Plays every job to game over (or maxFramesPerGame frames) and returns the aggregated results.
+    RunnerResults Run(const std::vector<SimJob>& jobs, int maxFramesPerGame);
+
+    int GetNumThreads() const { return numThreads; }
+
+    // Built-in policy: presses random keys (baseline / load generation).
+    static InputState RandomPolicy(const Simulation& game, uint64_t& rngState);
+
+private:
+    int numThreads;
+    std::vector<BotPolicy> policies;
+};
\ No newline at end of file
@@ -0,0 +1,190 @@
+/**
+ * @file simulation.hpp
+ * @brief Definition of the Simulation class.
+ * Headless Tetris rules engine: grid, pieces, RNG, scoring and levels.
+ * Has no raylib dependency, so it can be linked into servers, bots and trainers
+ * without a window or GPU context. Game adds rendering on top of it.
+ */
+
+#pragma once
+#include "grid.hpp"
+#include "piece_bag.hpp"
+#include "sim_clock.hpp"
+#include "../src/blocks.cpp"
+#include <type_traits>
+
+class ReplayWriter;
+
+// Structure to encapsulate input state for local and network processing
+struct InputState {
+    bool left;
+    bool right;
+    bool down;
+    bool rotate;
+    bool hardDrop;
+    bool reset;
+    int currentScore; // Informative only: never sent (boards are compared with Simulation::GetChecksum)
+};
+
+// An input stamped with the tick (network frame) it is applied on
+struct FrameInput {
+    uint32_t frame;
+    InputState input;
+};
+
+// Complete rules state of a Simulation as a plain value (bitboard grid, pieces, bag, scoring).
+// Copying it is a flat memcpy with no heap allocations, which is what search bots and
+// rollback need when they clone games millions of times (see Simulation::Save / Restore).
+struct Snapshot {
+    Grid grid;
+    Block currentBlock;
+    Block nextBlock;
+    PieceBag bag;
+    uint64_t tick;
+    uint32_t seed;
+    int32_t score;
+    int32_t level;
+    int32_t totalLinesCleared;
+    int32_t gravityCounter;
+    bool gameOver;
+};
+static_assert(std::is_trivially_copyable<Snapshot>::value, "Snapshot must stay a flat copy");
+
+class Simulation {
+public:
+    // Constructor
+    Simulation();
+
+    // --- Core Game Loop Methods ---
+    
+    // Processes input commands (movement, rotation)
+    void HandleInput(InputState input);
+    
+    // Moves the current block down by one cell. Returns true if successful.
+    bool MoveBlockDown();
+
+    // Drops the current block straight to its landing row and locks it.
+    void HardDrop();
+    
+    // --- Fixed-Timestep Stepping ---
+
+    // Advances the game by one fixed tick: applies the input, then steps gravity.
+    // The whole game is a function of the seed and the sequence of per-tick inputs.
+    // Returns true if gravity moved (or locked) the block this tick.
+    bool Tick(InputState input);
+
+    // Replays one recorded tick: like Tick, but the gravity step is taken from the recording
+    // instead of the level's gravity counter (works for games whose gravity came from the network).
+    void ReplayTick(InputState input, bool gravity);
+
+    // Streams every following Tick into a replay (nullptr stops recording). Reset also stops it,
+    // since a new game needs a new replay (see ReplayWriter::Begin).
+    void SetRecorder(ReplayWriter* writer) { recorder = writer; }
+
+    // Advances the gravity counter by one tick and moves the block down when it is due.
+    // Returns true if it did. Used directly when gravity comes from elsewhere (network server).
+    bool StepGravity();
+
+    // Frame-rate independent driver: feeds real elapsed time to 'clock' and runs the ticks it produces.
+    // The input is held until a tick consumes it, so a frame that produces no tick does not lose a key press.
+    // While 'stopTimer' is set (pause, countdown) no ticks run and the accumulated time is dropped.
+    // Returns the number of ticks run.
+    int Update(double elapsedSeconds, InputState input, bool stopTimer);
+
+    // Ticks between two gravity steps at the current level.
+    int GetGravityTicks() const;
+
+    // Ticks simulated since the last Reset.
+    uint64_t GetTick() const { return tick; }
+
+    // Seed actually used by the last Reset (the time-based one when no seed was given).
+    uint32_t GetSeed() const { return seed; }
+
+    // Zobrist hash of the position a player sees: grid occupancy, falling piece pose and next piece.
+    uint64_t GetStateHash() const;
+
+    // Desync check: GetStateHash plus the bag and the scoring state, everything later ticks depend on.
+    // O(1) (the grid hash is kept up to date incrementally), so it can be taken every tick.
+    uint64_t GetChecksum() const;
+
+    // --- Snapshots ---
+
+    // Copies the complete rules state into 'out'.
+    void Save(Snapshot& out) const;
+
+    // Puts the game back in a saved state. Input buffered by Update is dropped and recording stops
+    // (the replay would no longer match the game).
+    void Restore(const Snapshot& in);
+
+    // Resets the game state. Accepts an optional seed for deterministic RNG (network play).
+    void Reset(int seed = -1);
+
+    // Calculates the current fall speed based on the level.
+    double GetSpeed() const;
+
+    // --- Scoring Rules (shared with BatchSimulation) ---
+
+    // Points awarded for clearing a number of lines at once on a given level.
+    static int GetLinePoints(int linesCleared, int level);
+
+    // Level reached after clearing a total number of lines.
+    static int GetLevelForLines(int totalLines);
+
+    // --- Read-only State Access ---
+    const Grid& GetGrid() const { return grid; }
+    const Block& GetCurrentBlock() const { return currentBlock; }
+    const Block& GetNextBlock() const { return nextBlock; }
+
+    // Returns the ID of a queued piece after nextBlock (0 = the one that follows nextBlock).
+    // index must be below PieceBag::MAX_PREVIEW.
+    int PeekQueuedPiece(int index) { return bag.Peek(index); }
+
+    // --- Public State Variables ---
+    bool gameOver;
+    int score;
+    int level;             
+    int totalLinesCleared; 
+
+    // Real-time to tick converter for this instance (used by Update and for DAS timing)
+    SimClock clock;
+
+protected:
+    // --- Internal Logic Methods ---
+    
+    Block GetRandomBlock();
+    
+    void MoveBlockLeft();
+    void MoveBlockRight();
+    void RotateBlock();
+    
+    // Locks the current block into the grid and triggers line clearing
+    void LockBlock();
+    
+    // Collision Check (combined bounds + occupancy test against the grid)
+    bool BlockFits(const Block& block) const;
+    
+    void UpdateScore(int linesCleared, int moveDownPoints);
+
+    // Landing row of the current block, recomputed only after the block or the grid changes
+    int GetGhostRow();
+
+    // --- Member Variables ---
+    Grid grid;
+    Block currentBlock;
+    Block nextBlock;
+
+    // Ghost piece cache (invalidated by every move, rotation, lock and reset)
+    int ghostRow;
+    bool ghostDirty;
+    
+    // Instance-specific 7-bag piece generator (seeded by Reset)
+    PieceBag bag;
+
+    // Tick state (cleared by Reset)
+    uint64_t tick;
+    int gravityCounter;
+    InputState pendingInput;
+
+    uint32_t seed;
+    ReplayWriter* recorder;
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+/**
+ * @file spectator.hpp
+ * @brief Definition of the Spectator class.
+ * Watches a match hosted by a MatchServer. Connects with CONNECT_SPECTATOR and
+ * subscribes with PACKET_WATCH; from then on the server streams the round's
+ * seeds and the confirmed inputs of both boards (PACKET_WATCH_FRAMES), and the
+ * spectator simulates both boards itself, exactly as the server does. Nothing is
+ * predicted: the boards trail the players by the network delay plus a network
+ * tick. Whole boards (PACKET_WATCH_STATE) arrive only when joining mid-match.
+ * Headless, no raylib.
+ */
+
+#pragma once
+#include "packet_batcher.hpp"
+#include "rollback_session.hpp"
+#include "simulation.hpp"
+#include "wire_protocol.hpp"
+#include <cstdint>
+
+// Forward declarations for ENet structures to avoid including enet.h in the header
+struct _ENetHost;
+typedef struct _ENetHost ENetHost;
+struct _ENetPeer;
+typedef struct _ENetPeer ENetPeer;
+
+class Spectator {
+public:
+    Spectator();
+    ~Spectator();
+
+    // Connects to the MatchServer at 'hostName':'port' to watch match 'matchId' (0 = its oldest match).
+    bool Start(const char* hostName, int port, uint64_t matchId = 0);
+
+    // Leaves the match and destroys the host.
+    void Stop();
+
+    // Handles the pending network events (waiting up to 'waitMs' for the first one) and runs the
+    // frames received on both boards.
+    void Update(uint32_t waitMs = 0);
+
+    bool IsConnected() const { return isConnected; }
+
+    // The seeds arrived: the boards show the match.
+    bool IsWatching() const { return watching; }
+
+    // The match is over or the server turned us away (no such match); the connection is closing.
+    bool HasEnded() const { return ended; }
+
+    // Board 0 is the first player's (the host's seed), board 1 the second's.
+    const Simulation& GetBoard(int board) const { return boards[board]; }
+    uint32_t GetFrame(int board) const { return sessions[board].GetFrame(); }
+
+    // Rounds started since Start (restarts included).
+    uint32_t GetRoundCount() const { return rounds; }
+
+    // Frames simulated on both boards since Start.
+    uint64_t GetFramesSimulated() const { return framesSimulated; }
+
+private:
+    void HandleMessage(const NetMessage& message);
+
+    ENetHost* host;
+    ENetPeer* peer;
+    uint64_t matchId;
+    bool isConnected;
+    bool watching;
+    bool ended;
+
+    Simulation boards[2];
+    RollbackSession sessions[2];   // Confirmed frames only (no prediction)
+    uint32_t rounds;
+    uint64_t framesSimulated;
+};
@@ -0,0 +1,51 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Definition of the SpscQueue class template.
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * A ring of Capacity slots indexed by two monotonically increasing counters: the
+ * producer owns 'tail', the consumer owns 'head', and each only reads the other's
+ * counter (acquire) to know how far it may go. Each counter sits on its own cache
+ * line so the two threads do not invalidate each other on every operation.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Items are copied in and out of the ring");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer only. Returns false (and drops nothing) when the queue is full.
+    bool Push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false when the queue is empty.
+    bool Pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called from a third thread.
+    size_t Size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) T items[Capacity];
+};
@@ -0,0 +1,53 @@
+/**
+ * @file transposition_table.hpp
+ * @brief Definition of the TranspositionTable class.
+ * Fixed-size cache of search results keyed by Zobrist hash, shared by all search
+ * threads without locks. Each slot holds two 64-bit words written with relaxed
+ * atomics: the value and (key ^ value). A probe only accepts a slot whose words
+ * XOR back to its key, so a slot torn by two concurrent writers reads as a miss
+ * instead of a wrong value. Newer entries always replace older ones.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class TranspositionTable {
+public:
+    // 'entries' is rounded up to a power of two (16 bytes each).
+    explicit TranspositionTable(size_t entries = 1 << 16);
+
+    // Looks up 'key'. Returns true and sets 'value' on a hit.
+    bool Probe(uint64_t key, double& value) const;
+
+    // Stores the value of 'key', replacing whatever shared its slot.
+    void Store(uint64_t key, double value);
+
+    // Empties every slot (not thread-safe against concurrent Probe/Store).
+    void Clear();
+
+    // Adds to the hit-rate counters. Searches count locally and report once per
+    // batch, so the counters are not contended on every probe.
+    void AddStats(uint64_t probes, uint64_t hits);
+    void ResetStats();
+
+    uint64_t GetProbes() const { return probes.load(std::memory_order_relaxed); }
+    uint64_t GetHits() const { return hits.load(std::memory_order_relaxed); }
+    double GetHitRate() const;
+    size_t GetSize() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;   // key ^ data ^ EMPTY_CHECK
+        std::atomic<uint64_t> data;    // Bits of the stored value
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    // Kept on their own cache line, away from the slots
+    alignas(64) std::atomic<uint64_t> probes;
+    std::atomic<uint64_t> hits;
+};
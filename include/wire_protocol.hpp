@@ -0,0 +1,128 @@
+/**
+ * @file wire_protocol.hpp
+ * @brief Definition of the WireProtocol class and the network message types.
+ * Compact, endian-safe encoding of every packet exchanged by NetworkManager,
+ * MatchServer and ShardedServer. Packets are built and parsed field by field,
+ * never cast from raw bytes, so struct padding and host byte order do not matter.
+ *
+ * Layout:
+ *   Header (1 byte): type in bits 0-4, protocol VERSION in bits 5-7
+ *   PACKET_INPUT    : round (u8), ack (varint), first frame (varint), frame count (varint),
+ *                     input count (u8), then per input: frame gap (varint, from the previous
+ *                     input or the first frame), input mask (u8, ReplayInputBits layout,
+ *                     without REPLAY_RESET: a window with the reset bit is malformed)
+ *   PACKET_CHECKSUM : round (u8), frame (varint), checksum (u64 LE)
+ *   PACKET_STATE    : frame (varint), board (replay keyframe body, see ReplayWriter::EncodeSnapshot)
+ *   PACKET_WATCH_FRAMES : board (u8), first frame (varint), frame count (varint), input count (u8),
+ *                     then the inputs as in PACKET_INPUT
+ *   PACKET_WATCH_STATE  : board (u8), then as PACKET_STATE
+ *   PACKET_SEED     : round (u8), seedHost (u32 LE), seedClient (u32 LE)
+ *   PACKET_*_RES    : accepted (u8)
+ *   PACKET_REDIRECT : port (u16 LE), token (u64 LE)
+ *   PACKET_JOIN / PACKET_WATCH : token (u64 LE)
+ *   Others          : header only
+ * A typical input window is 6-12 bytes, a request a single byte. Messages are
+ * self-delimiting, so one ENet packet can carry several of them back to back
+ * (see PacketBatcher). PACKET_STATE and PACKET_WATCH_STATE (about 45-150 bytes)
+ * are the only messages larger than MAX_MESSAGE_SIZE; they are built with
+ * EncodeState / AppendWatchState and sent on their own.
+ */
+
+#pragma once
+#include "simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Enumeration of all packet types used for communication
+enum PacketType { 
+    PACKET_INPUT,       // Sender's inputs of the frames the receiver has not acknowledged (unreliable)
+    PACKET_SEED,        // RNG Seeds for synchronization
+    PACKET_RESTART_REQ, // Request to restart
+    PACKET_RESTART_RES, // Response to restart
+    PACKET_PAUSE_REQ,   // Request to pause
+    PACKET_PAUSE_RES,   // Response to pause
+    PACKET_RESUME_REQ,  // Request to resume
+    PACKET_RESUME_RES,  // Response to resume
+    PACKET_QUIT,        // Player disconnected/quit
+    PACKET_NEW_GAME,    // Force new game sync
+    PACKET_REDIRECT,    // Server lobby: reconnect to a match shard (Server to Client)
+    PACKET_JOIN,        // Claim a match slot on a shard (Client to Server)
+    PACKET_CHECKSUM,    // Sampled checksum of the sender's board before 'frame' (desync detection)
+    PACKET_RESYNC_REQ,  // The receiver's board went out of sync: send it a PACKET_STATE
+    PACKET_STATE,       // The sender's whole board before 'frame' (answer to PACKET_RESYNC_REQ)
+    PACKET_WATCH,       // Spectator: subscribe to a match (Client to Server)
+    PACKET_WATCH_FRAMES,// Spectator stream: confirmed inputs of one board (Server to Spectators)
+    PACKET_WATCH_STATE, // Spectator stream: one whole board, to continue from (Server to Spectators)
+    PACKET_TYPE_COUNT
+};
+
+// ENet connect data of a spectator (players connect with 0): the server never pairs it as a player.
+static constexpr uint32_t CONNECT_SPECTATOR = 0x53504543;
+
+// Most inputs one PACKET_INPUT carries; a longer backlog is sent over several network ticks.
+static constexpr int MAX_WINDOW_INPUTS = 16;
+
+// One decoded packet. Only the fields of its type are meaningful.
+struct NetMessage {
+    PacketType type;
+    uint8_t round;              // PACKET_SEED / PACKET_INPUT / PACKET_CHECKSUM: round the frames belong to
+    uint8_t board;              // PACKET_WATCH_*: board of the match (0 or 1, the seedHost / seedClient
+                                // of the spectator's PACKET_SEED)
+    uint32_t ack;               // PACKET_INPUT: frames of the receiver's stream the sender has confirmed
+    uint32_t frame;             // PACKET_INPUT: first frame covered (the ack the sender last received).
+                                // PACKET_WATCH_FRAMES: first frame covered.
+                                // PACKET_CHECKSUM / PACKET_*STATE: frame of the board state
+    uint32_t endFrame;          // PACKET_INPUT / PACKET_WATCH_FRAMES: every frame before it is covered (idle unless listed)
+    int inputCount;             // PACKET_INPUT / PACKET_WATCH_FRAMES: listed inputs, in frame order (buttons only)
+    FrameInput inputs[MAX_WINDOW_INPUTS];
+    uint64_t checksum;          // PACKET_CHECKSUM: Simulation::GetChecksum of the board
+    const uint8_t* state;       // PACKET_*STATE: encoded board, points into the decoded packet (see DecodeState)
+    size_t stateSize;
+    uint32_t seedHost;          // PACKET_SEED: seed of the host's board (the receiver's remote board)
+    uint32_t seedClient;        // PACKET_SEED: seed of the receiver's own board
+    bool accepted;              // PACKET_*_RES
+    uint16_t port;              // PACKET_REDIRECT: port of the shard hosting the match
+    uint64_t token;             // PACKET_REDIRECT / PACKET_JOIN: match slot to claim.
+                                // PACKET_WATCH: match to watch (MatchServer id, 0 = the oldest running)
+};
+
+class WireProtocol {
+public:
+    // Version 5 headers are 0xA0-0xBF, bytes no earlier build sent: the raw-struct packets start with
+    // 0-10, the 2-bit version layout (versions 1-3, version in bits 6-7) with 0x40-0x7F, 0x80-0xBF
+    // and 0xC0-0xFF, its types staying below 32. Those builds read 0xA0-0xBF as another version or
+    // a type past their last one, so each side drops the other's packets. A new version must keep
+    // both properties: headers no earlier build produced, rejected by every earlier decoder.
+    static constexpr uint8_t VERSION = 5;
+
+    // Largest encoded message (a full input window), for stack buffers.
+    static constexpr size_t MAX_MESSAGE_SIZE = 128;
+
+    // Encodes 'message' into 'out' (MAX_MESSAGE_SIZE bytes) and returns its length. Not for PACKET_*STATE.
+    static size_t Encode(const NetMessage& message, uint8_t* out);
+
+    // Encodes a PACKET_STATE message carrying 'state', the board before 'frame', into 'out'.
+    static void EncodeState(uint32_t frame, const Snapshot& state, std::vector<uint8_t>& out);
+
+    // Appends a PACKET_WATCH_STATE message carrying board 'board' of a match, before 'frame', to 'out'.
+    static void AppendWatchState(uint8_t board, uint32_t frame, const Snapshot& state, std::vector<uint8_t>& out);
+
+    // Decodes the board of a PACKET_STATE or PACKET_WATCH_STATE message (validated by DecodeNext). The seed is not sent:
+    // 'state' keeps the one it already holds.
+    static bool DecodeState(const NetMessage& message, Snapshot& state);
+
+    // Decodes a packet holding exactly one message. Returns false for another protocol version,
+    // an unknown type, a truncated body or trailing bytes; 'message' is then left unspecified.
+    static bool Decode(const uint8_t* data, size_t size, NetMessage& message);
+
+    // Decodes the message starting at 'pos' and moves 'pos' past it. Returns false (leaving 'pos')
+    // at the end of the data or on a malformed message; the rest of the packet must then be dropped.
+    static bool DecodeNext(const uint8_t* data, size_t size, size_t& pos, NetMessage& message);
+
+    // Builders for the common messages.
+    static NetMessage Make(PacketType type);
+    static NetMessage MakeChecksum(uint8_t round, uint32_t frame, uint64_t checksum);
+    static NetMessage MakeSeed(uint8_t round, uint32_t seedHost, uint32_t seedClient);
+    static NetMessage MakeResponse(PacketType type, bool accepted);
+};
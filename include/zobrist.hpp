@@ -0,0 +1,34 @@
+/**
+ * @file zobrist.hpp
+ * @brief Definition of the Zobrist class.
+ * Zobrist hashing of board occupancy and piece state: every cell, piece pose and
+ * next-piece value has a fixed random 64-bit key, and a position hashes to the XOR
+ * of the keys it contains. Filling or emptying a cell toggles one key, so Grid keeps
+ * its hash up to date in O(1) per cell. Colors are not hashed (they never change
+ * the rules or an evaluation). Keys are generated from a fixed seed, so hashes are
+ * identical across runs and machines.
+ */
+
+#pragma once
+#include <cstdint>
+
+class Zobrist {
+public:
+    // Key of a single filled cell.
+    static uint64_t Cell(int row, int column);
+
+    // XOR of the cell keys of a row mask (walls ignored, see Grid::ColumnBit). Two table lookups.
+    static uint64_t Row(int row, uint16_t mask);
+
+    // Hash of the first 'count' rows of a row-mask array (Grid::NUM_ROWS for a whole board).
+    static uint64_t Rows(const uint16_t* rows, int count);
+
+    // Key of the falling piece's pose (id 1-7, rotation 0-3, row and column of its origin).
+    static uint64_t Piece(int id, int rotation, int row, int column);
+
+    // Key of the next (previewed) piece id.
+    static uint64_t Next(int id);
+
+    // SplitMix64 finalizer, for state that has no key table (see PieceBag::GetChecksum).
+    static uint64_t Mix(uint64_t value);
+};
@@ -15,8 +15,6 @@
 
 #include <enet/enet.h>
 #include "../include/NetworkManager.hpp"
-#include "raylib.h" 
-#include "../include/utils.hpp" 
 #include <iostream>
 #include <ctime>
 #include <string>
@@ -24,12 +22,11 @@
 // --- LOCAL HELPER FUNCTIONS ---
 
 // Resets synchronization state variables.
-// Ensures the game starts smoothly by unpausing, setting the countdown,
-// and resetting the time accumulator in Utils.
+// Ensures the game starts smoothly by unpausing and setting the countdown
+// (the game clocks drop their accumulated time while the countdown runs).
 static void ResetSyncState(bool& isPausedGame, float& countdownTimer) {
     isPausedGame = false;
     countdownTimer = 3.5f;
-    Utils::EventTriggered(0, true); // Force reset of lastUpdateTime in Utils
 }
 
 // --- CONSTRUCTOR / DESTRUCTOR ---
@@ -39,8 +36,8 @@ NetworkManager::NetworkManager()
       pauseRequestReceived(false), pauseRequestPending(false),
       resumeRequestReceived(false), resumeRequestPending(false),
       opponentQuit(false), remoteStartedNewGame(false),
-      role(NONE), isConnected(false), 
-      host(nullptr), peer(nullptr) 
+      role(NONE), isConnected(false), isRedirecting(false),
+      host(nullptr), peer(nullptr), redirectPort(0), joinToken(0) 
 {
     if (enet_initialize() != 0) {
         std::cerr << "[Network] Error initializing ENet!\n";
@@ -59,8 +56,8 @@ bool NetworkManager::StartServer(int port) {
     address.host = ENET_HOST_ANY;
     address.port = (enet_uint16)port;
     
-    // Create host allowing 32 connections, 2 channels, no bandwidth limits
-    host = enet_host_create(&address, 32, 2, 0, 0);
+    // Create host allowing 32 connections, control and frame channels, no bandwidth limits
+    host = enet_host_create(&address, 32, CHANNEL_COUNT, 0, 0);
     
     if (host) { 
         role = SERVER; 
@@ -75,17 +72,20 @@ bool NetworkManager::StartClient(const char* hostName, int port) {
         enet_host_destroy(host);
         host = nullptr;
     }
+    batcher.Discard(outgoing);
 
     // Create client host (1 connection allowed)
-    host = enet_host_create(NULL, 1, 2, 0, 0);
+    host = enet_host_create(NULL, 1, CHANNEL_COUNT, 0, 0);
     if (!host) return false;
 
     ENetAddress address;
     enet_address_set_host(&address, hostName);
     address.port = (enet_uint16)port;
+    serverHost = hostName;
+    roundStarted = false; // Waits for the seeds
     
     // Initiate connection
-    peer = enet_host_connect(host, &address, 2, 0);
+    peer = enet_host_connect(host, &address, CHANNEL_COUNT, 0);
     
     if (peer) { 
         role = CLIENT; 
@@ -97,31 +97,40 @@ bool NetworkManager::StartClient(const char* hostName, int port) {
 
 // --- DATA SENDING METHODS ---
 
-void NetworkManager::SendInput(InputState input) {
+void NetworkManager::Send(const NetMessage& message) {
     if (!peer) return;
-    struct { PacketType type; InputState data; } p = { PACKET_INPUT, input };
-    ENetPacket* packet = enet_packet_create(&p, sizeof(p), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(peer, 0, packet);
+    batcher.Queue(peer, outgoing, message);
 }
 
-void NetworkManager::SendSeed(unsigned int seedHost, unsigned int seedClient) {
-    if (!peer) return;
-    struct { PacketType type; unsigned int s1; unsigned int s2; } p = { PACKET_SEED, seedHost, seedClient };
-    ENetPacket* packet = enet_packet_create(&p, sizeof(p), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(peer, 0, packet);
+void NetworkManager::Flush(double elapsedSeconds) {
+    if (!peer) {
+        batcher.Discard(outgoing);
+        return;
+    }
+    if (!batcher.IsTickDue(elapsedSeconds)) return;
+    batcher.Send(peer, outgoing);
+
+    // Input window (with our ack of the opponent's frames), unless both sides are up to date
+    PacketBatch frameBatch;
+    if (roundStarted && frames.Queue(batcher, peer, frameBatch, rollback.GetConfirmedFrame())) {
+        batcher.Send(peer, frameBatch, CHANNEL_FRAMES);
+    }
 }
 
-void NetworkManager::SendTick() {
-    if (!peer || role != SERVER) return;
-    PacketType type = PACKET_TICK;
-    ENetPacket* packet = enet_packet_create(&type, sizeof(type), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(peer, 0, packet);
+void NetworkManager::SendInput(uint32_t frame, InputState input) {
+    frames.AddInput(frame, input);
+    frames.SetFrameCount(frame + 1);
+}
+
+void NetworkManager::SendSeed(unsigned int seedHost, unsigned int seedClient) {
+    uint8_t round = (uint8_t)(frames.GetRound() + 1);
+    Send(WireProtocol::MakeSeed(round, seedHost, seedClient));
+    StartRound(round);
 }
 
 void NetworkManager::SendRequest(PacketType type) {
     if (!peer) return;
-    ENetPacket* packet = enet_packet_create(&type, sizeof(type), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(peer, 0, packet);
+    Send(WireProtocol::Make(type));
     
     // Set pending flags based on request type
     if (type == PACKET_RESTART_REQ) restartRequestPending = true;
@@ -130,30 +139,89 @@ void NetworkManager::SendRequest(PacketType type) {
 }
 
 void NetworkManager::SendResponse(PacketType type, bool accepted) {
-    if (!peer) return;
-    struct { PacketType t; bool a; } p = { type, accepted };
-    ENetPacket* packet = enet_packet_create(&p, sizeof(p), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(peer, 0, packet);
+    Send(WireProtocol::MakeResponse(type, accepted));
 }
 
 void NetworkManager::SendQuit() {
     if (!peer) return;
-    PacketType type = PACKET_QUIT;
-    ENetPacket* packet = enet_packet_create(&type, sizeof(type), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(peer, 0, packet);
+    Send(WireProtocol::Make(PACKET_QUIT));
+    batcher.Send(peer, outgoing);
     enet_host_flush(host); // Force send immediately
 }
 
 void NetworkManager::SendNewGameSignal() {
-    if (!peer) return;
-    PacketType type = PACKET_NEW_GAME;
-    ENetPacket* packet = enet_packet_create(&type, sizeof(type), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(peer, 0, packet);
+    Send(WireProtocol::Make(PACKET_NEW_GAME));
+}
+
+// --- FRAME STEPPING ---
+
+void NetworkManager::StartRound(uint8_t round) {
+    rollback.Start();
+    frames.Reset(round);
+    roundStarted = true;
+    localFrame = 0;
+    pendingInput = InputState{};
+}
+
+int NetworkManager::StepLocal(Simulation& localGame, InputState input, double elapsedSeconds, bool stopTimer) {
+    // Merge this frame's presses into the ones not yet consumed by a tick. 'reset' is left out:
+    // online rounds restart through PACKET_RESTART_* and the seeds, never from an input
+    pendingInput.left |= input.left;
+    pendingInput.right |= input.right;
+    pendingInput.down |= input.down;
+    pendingInput.rotate |= input.rotate;
+    pendingInput.hardDrop |= input.hardDrop;
+
+    if (stopTimer || !roundStarted) {
+        localGame.clock.Reset();
+        pendingInput = InputState{};
+        return 0;
+    }
+
+    int ticks = localGame.clock.Advance(elapsedSeconds);
+    for (int i = 0; i < ticks; i++) {
+        if (localFrame % RollbackSession::CHECKSUM_INTERVAL == 0) {
+            frames.AddChecksum(localFrame, localGame.GetChecksum());
+        }
+        pendingInput.reset = false;
+        SendInput(localFrame, pendingInput);
+        localGame.Tick(pendingInput);
+        pendingInput = InputState{};
+        localFrame++;
+    }
+    return ticks;
+}
+
+// --- RESYNC ---
+
+void NetworkManager::SendState(const Simulation& localGame) {
+    if (!peer || !roundStarted) return;
+    Snapshot state;
+    localGame.Save(state);
+    std::vector<uint8_t> message;
+    WireProtocol::EncodeState(localFrame, state, message);
+    batcher.SendLarge(peer, outgoing, message);
+}
+
+void NetworkManager::ApplyState(Simulation& remoteGame, const NetMessage& message) {
+    if (!roundStarted) return;
+
+    // Decoded over the current state, which keeps the seed
+    Snapshot state;
+    remoteGame.Save(state);
+    if (!WireProtocol::DecodeState(message, state)) return;
+
+    // Overtaken by too many newer inputs: ask for a fresher one
+    if (!rollback.Resync(message.frame)) {
+        Send(WireProtocol::Make(PACKET_RESYNC_REQ));
+        return;
+    }
+    remoteGame.Restore(state);
 }
 
 // --- MAIN UPDATE LOOP ---
 
-void NetworkManager::Update(Game& localGame, Game& remoteGame, bool& isPausedGame, float& countdownTimer, bool useSameSeeds) {
+void NetworkManager::Update(Simulation& localGame, Simulation& remoteGame, bool& isPausedGame, float& countdownTimer, bool useSameSeeds) {
     if (!host) return;
     ENetEvent event;
 
@@ -165,6 +233,15 @@ void NetworkManager::Update(Game& localGame, Game& remoteGame, bool& isPausedGam
             peer = event.peer;
             isConnected = true;
             opponentQuit = false;
+
+            // Client arriving on a match shard: claim the slot the lobby reserved
+            if (role == CLIENT && joinToken != 0) {
+                NetMessage join = WireProtocol::Make(PACKET_JOIN);
+                join.token = joinToken;
+                Send(join);
+                joinToken = 0;
+                isRedirecting = false;
+            }
             
             // If Server: Determine Seeds and Start Game
             if (role == SERVER) {
@@ -181,75 +258,91 @@ void NetworkManager::Update(Game& localGame, Game& remoteGame, bool& isPausedGam
         
         // 2. PACKET RECEIVED
         else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
-            PacketType* type = (PacketType*)event.packet->data;
-
-            switch (*type) {
-                case PACKET_INPUT: {
-                    // Apply opponent's input and update their score/level representation
-                    struct { PacketType t; InputState d; }* pi = (decltype(pi))event.packet->data;
-                    remoteGame.HandleInput(pi->d);
-                    remoteGame.score = pi->d.currentScore; 
-                    remoteGame.level = 1 + (remoteGame.totalLinesCleared / 10);
-                    break;
-                }
-                case PACKET_SEED: { 
-                    // Client: Receive initial seeds from Server
-                    struct { PacketType t; unsigned int s1; unsigned int s2; }* ps = (decltype(ps))event.packet->data;
-                    localGame.Reset(ps->s2);  
-                    remoteGame.Reset(ps->s1); 
+            // One packet carries every message of a network tick. A malformed message
+            // (or another protocol version) drops the rest of the packet.
+            NetMessage message;
+            size_t pos = 0;
+            while (WireProtocol::DecodeNext(event.packet->data, event.packet->dataLength, pos, message)) {
+                switch (message.type) {
+                    // Opponent's inputs are applied on their frame by the rollback session (after polling).
+                    // Windows repeat unacknowledged inputs; those of another round are stale.
+                    case PACKET_INPUT: {
+                        if (!roundStarted || message.round != frames.GetRound()) break;
+                        for (int i = 0; i < message.inputCount; i++) {
+                            rollback.AddInput(message.inputs[i].frame, message.inputs[i].input);
+                        }
+                        rollback.Confirm(message.endFrame);
+                        frames.OnWindow(message, rollback.GetConfirmedFrame());
+                        break;
+                    }
+
+                    // Desync detection and recovery
+                    case PACKET_CHECKSUM: {
+                        if (roundStarted && message.round == frames.GetRound()) rollback.AddChecksum(message.frame, message.checksum);
+                        break;
+                    }
+                    case PACKET_RESYNC_REQ: SendState(localGame); break;
+                    case PACKET_STATE:      ApplyState(remoteGame, message);                       break;
+
+                    case PACKET_SEED: { 
+                        // Client: Receive initial seeds from Server
+                        localGame.Reset(message.seedClient);  
+                        remoteGame.Reset(message.seedHost); 
+                        StartRound(message.round);
                     
-                    ResetSyncState(isPausedGame, countdownTimer);
-                    break;
-                }
-                case PACKET_TICK: {
-                    // Client: Apply gravity signal from Server
-                    if (role == CLIENT && countdownTimer <= 0) {
-                        localGame.MoveBlockDown();
-                        remoteGame.MoveBlockDown();
+                        ResetSyncState(isPausedGame, countdownTimer);
+                        break;
                     }
-                    break;
-                }
                 
-                // Simple Requests
-                case PACKET_RESTART_REQ: restartRequestReceived = true; break;
-                case PACKET_PAUSE_REQ:   pauseRequestReceived = true;   break;
-                case PACKET_RESUME_REQ:  resumeRequestReceived = true;  break;
-                case PACKET_QUIT:        opponentQuit = true;           break;
-                case PACKET_NEW_GAME:    remoteStartedNewGame = true;   break;
-
-                // Responses
-                case PACKET_RESTART_RES: {
-                    struct { PacketType t; bool a; }* res = (decltype(res))event.packet->data;
-                    restartRequestPending = false;
-                    if (res->a) {
-                        // If accepted, Server generates new seeds
-                        if (role == SERVER) {
-                            unsigned int s1 = (unsigned int)time(NULL);
-                            unsigned int s2 = useSameSeeds ? s1 : s1 + 9999;
-                            SendSeed(s1, s2); 
-                            localGame.Reset(s1); remoteGame.Reset(s2);
-                        } else { 
-                            localGame.Reset(); remoteGame.Reset(); 
+                    // Simple Requests
+                    case PACKET_RESTART_REQ: restartRequestReceived = true; break;
+                    case PACKET_PAUSE_REQ:   pauseRequestReceived = true;   break;
+                    case PACKET_RESUME_REQ:  resumeRequestReceived = true;  break;
+                    case PACKET_QUIT:        opponentQuit = true;           break;
+                    case PACKET_NEW_GAME:    remoteStartedNewGame = true;   break;
+
+                    case PACKET_REDIRECT: {
+                        // Client: the lobby paired us, the match runs on another port (handled after polling)
+                        if (role == CLIENT) {
+                            redirectPort = message.port;
+                            joinToken = message.token;
                         }
-                        ResetSyncState(isPausedGame, countdownTimer); 
+                        break;
                     }
-                    break;
-                }
-                case PACKET_PAUSE_RES: {
-                    struct { PacketType t; bool a; }* res = (decltype(res))event.packet->data;
-                    pauseRequestPending = false;
-                    if (res->a) isPausedGame = true; 
-                    break;
-                }
-                case PACKET_RESUME_RES: {
-                    struct { PacketType t; bool a; }* res = (decltype(res))event.packet->data;
-                    resumeRequestPending = false;
-                    if (res->a) {
-                        ResetSyncState(isPausedGame, countdownTimer); 
+
+                    // Responses
+                    case PACKET_RESTART_RES: {
+                        restartRequestPending = false;
+                        if (message.accepted) {
+                            // If accepted, Server generates new seeds
+                            if (role == SERVER) {
+                                unsigned int s1 = (unsigned int)time(NULL);
+                                unsigned int s2 = useSameSeeds ? s1 : s1 + 9999;
+                                SendSeed(s1, s2); 
+                                localGame.Reset(s1); remoteGame.Reset(s2);
+                            } else { 
+                                // Client: the new round starts with the host's seeds
+                                localGame.Reset(); remoteGame.Reset(); 
+                                roundStarted = false;
+                            }
+                            ResetSyncState(isPausedGame, countdownTimer); 
+                        }
+                        break;
+                    }
+                    case PACKET_PAUSE_RES: {
+                        pauseRequestPending = false;
+                        if (message.accepted) isPausedGame = true; 
+                        break;
+                    }
+                    case PACKET_RESUME_RES: {
+                        resumeRequestPending = false;
+                        if (message.accepted) {
+                            ResetSyncState(isPausedGame, countdownTimer); 
+                        }
+                        break;
                     }
-                    break;
+                    default: break;
                 }
-                default: break;
             }
             enet_packet_destroy(event.packet);
         } 
@@ -258,17 +351,44 @@ void NetworkManager::Update(Game& localGame, Game& remoteGame, bool& isPausedGam
         else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
             isConnected = false;
             peer = nullptr;
+            batcher.Discard(outgoing);
+            isRedirecting = false; // A shard that never answers ends up here: back to the lobby
             if (role == SERVER) opponentQuit = true; 
         }
     }
+
+    // Opponent's board: correct mispredictions, then predict up to our own frame
+    if (roundStarted && rollback.Advance(remoteGame, localFrame)) {
+        desyncDetected = true;
+        if (autoResync) Send(WireProtocol::Make(PACKET_RESYNC_REQ));
+    }
+
+    // Leave the lobby and connect to the shard (the host cannot be replaced while it is being polled)
+    if (redirectPort != 0) {
+        int port = redirectPort;
+        uint64_t token = joinToken;
+        redirectPort = 0;
+        batcher.Discard(outgoing);
+        if (peer) {
+            enet_peer_disconnect(peer, 0);
+            enet_host_flush(host);
+        }
+        peer = nullptr;
+        isConnected = false;
+        std::string lobbyHost = serverHost;
+        isRedirecting = StartClient(lobbyHost.c_str(), port);
+        joinToken = token;
+    }
 }
 
 void NetworkManager::Stop() {
     if (peer) {
+        batcher.Send(peer, outgoing);
         enet_peer_disconnect(peer, 0);
         enet_host_flush(host);
     }
     if (host) enet_host_destroy(host);
+    batcher.Discard(outgoing);
     
     host = nullptr; peer = nullptr; isConnected = false; role = NONE;
     
@@ -276,7 +396,9 @@ void NetworkManager::Stop() {
     restartRequestReceived = false; restartRequestPending = false;
     pauseRequestReceived = false; pauseRequestPending = false;
     resumeRequestReceived = false; resumeRequestPending = false;
-    opponentQuit = false; remoteStartedNewGame = false;
+    opponentQuit = false; remoteStartedNewGame = false; desyncDetected = false;
+    isRedirecting = false; redirectPort = 0; joinToken = 0;
+    roundStarted = false; localFrame = 0;
 }
 
 std::string NetworkManager::GetLocalIPInfo() {
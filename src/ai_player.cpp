@@ -0,0 +1,332 @@
+/**
+ * @file ai_player.cpp
+ * @brief Implementation of the AIPlayer class.
+ */
+
+#include "../include/ai_player.hpp"
+#include "../include/zobrist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+// Playfield columns of a row mask (walls excluded)
+static const uint16_t PLAYFIELD_MASK = (uint16_t)~Grid::EMPTY_ROW;
+
+// Longest path the bot looks at when choosing the next move
+static const int MAX_PATH = 64;
+
+// --- LOCAL HELPER FUNCTIONS ---
+
+// Identifies the cells covered by a placement, so that a lock position reported through
+// a symmetric rotation (see PlacementEnumerator) still matches the planned target.
+static uint64_t CellsKey(int id, int rotation, int row, int column) {
+    const std::array<uint8_t, 4>& masks = Block::GetRowMasks(id, rotation);
+    int top = 0;
+    while (top < 3 && masks[top] == 0) top++;
+
+    uint64_t key = (uint64_t)(row + top - PlacementEnumerator::ROW_MIN) << 40;
+    for (int k = top; k < 4; k++) {
+        uint64_t cells = ((uint32_t)masks[k] << Grid::ColumnBit(column)) >> Grid::WALL_BITS;
+        key |= (cells & 0x3FF) << (10 * (k - top));
+    }
+    return key;
+}
+
+// --- CONSTRUCTOR ---
+
+AIPlayer::AIPlayer(int lookahead, int beamWidth, int numThreads)
+    : lookahead(std::max(0, std::min(lookahead, PieceBag::MAX_PREVIEW + 1))),
+      beamWidth(std::max(1, beamWidth)),
+      workGeneration(0), workPiece(0), workCount(0), workShare(0), workPending(0), stopping(false),
+      hasTarget(false), targetRotation(0), targetRow(0), targetColumn(0), lastMoveTick(0), lastDecisionMs(0) {
+    if (numThreads <= 0) numThreads = (int)std::thread::hardware_concurrency();
+    this->numThreads = std::max(1, numThreads);
+
+    // One enumerator and output buffer per worker, sized for a full beam up front
+    for (int w = 0; w < this->numThreads; w++) {
+        enumerators.emplace_back(new PlacementEnumerator());
+        workerOutput.emplace_back();
+        workerOutput.back().reserve((size_t)this->beamWidth * 64);
+    }
+    beam.reserve((size_t)this->beamWidth * 64);
+    memset(decidedRows, 0, sizeof(decidedRows));
+
+    // The calling thread is worker 0
+    for (int w = 1; w < this->numThreads; w++) workers.emplace_back(&AIPlayer::WorkerLoop, this, w);
+}
+
+AIPlayer::~AIPlayer() {
+    {
+        std::lock_guard<std::mutex> guard(workLock);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void AIPlayer::Reset() {
+    hasTarget = false;
+    lastMoveTick = 0;
+    evalCache.Clear();
+}
+
+// --- HEURISTIC ---
+
+double AIPlayer::EvaluateBoard(const uint16_t* rows, const AIWeights& weights) {
+    int heights[Grid::NUM_COLUMNS] = {0};
+    uint16_t covered = 0;
+    int holes = 0;
+
+    // Top to bottom: a column's height is set by its first filled cell,
+    // every empty cell under a filled one is a hole
+    for (int row = 0; row < Grid::NUM_ROWS; row++) {
+        uint16_t cells = rows[row] & PLAYFIELD_MASK;
+        holes += __builtin_popcount((uint16_t)~cells & covered);
+
+        uint16_t fresh = cells & ~covered;
+        while (fresh) {
+            int bit = __builtin_ctz(fresh);
+            fresh &= fresh - 1;
+            heights[bit - Grid::WALL_BITS] = Grid::NUM_ROWS - row;
+        }
+        covered |= cells;
+    }
+
+    int aggregateHeight = 0, bumpiness = 0;
+    for (int column = 0; column < Grid::NUM_COLUMNS; column++) {
+        aggregateHeight += heights[column];
+        if (column > 0) bumpiness += std::abs(heights[column] - heights[column - 1]);
+    }
+
+    return weights.aggregateHeight * aggregateHeight + weights.holes * holes + weights.bumpiness * bumpiness;
+}
+
+// --- SEARCH ---
+
+void AIPlayer::MakeChild(const Node& parent, int id, const Placement& placement, Node& child, uint64_t& hits) {
+    memcpy(child.rows, parent.rows, sizeof(child.rows));
+    child.hash = parent.hash;
+    child.lines = parent.lines;
+    child.firstPlacement = parent.firstPlacement;
+
+    // Lock: only the piece cells toggle their keys
+    const std::array<uint8_t, 4>& masks = Block::GetRowMasks(id, placement.rotation);
+    int shift = Grid::ColumnBit(placement.column);
+    for (int k = 0; k < 4; k++) {
+        if (masks[k] == 0) continue;
+        uint16_t cells = (uint16_t)(masks[k] << shift);
+        child.rows[placement.row + k] |= cells;
+        child.hash ^= Zobrist::Row(placement.row + k, cells);
+    }
+
+    // Clear: the rows down to the lowest full one move, rehash that band (as Grid::ClearFullRows)
+    uint32_t fullRows = Grid::FindFullRows(child.rows);
+    if (fullRows) {
+        int band = 32 - __builtin_clz(fullRows);
+        child.hash ^= Zobrist::Rows(child.rows, band);
+        Grid::ClearFullRowMasks(child.rows, nullptr);
+        child.hash ^= Zobrist::Rows(child.rows, band);
+        child.lines += __builtin_popcount(fullRows);
+    }
+
+    double value;
+    if (evalCache.Probe(child.hash, value)) hits++;
+    else {
+        value = EvaluateBoard(child.rows, weights);
+        evalCache.Store(child.hash, value);
+    }
+    child.score = value + weights.linesCleared * child.lines;
+}
+
+void AIPlayer::Expand(const std::vector<Node>& nodes, size_t begin, size_t end, int id,
+                      PlacementEnumerator& enumerator, std::vector<Node>& out) {
+    Block spawn = CreateBlock(id);
+    uint64_t probes = 0, hits = 0;
+    for (size_t i = begin; i < end; i++) {
+        const Node& node = nodes[i];
+
+        // No placement means the piece cannot even spawn: this line of play loses
+        int count = enumerator.Enumerate(node.rows, id, spawn.GetRotation(), spawn.GetRow(), spawn.GetColumn());
+        for (int p = 0; p < count; p++) {
+            out.emplace_back();
+            MakeChild(node, id, enumerator.GetPlacement(p), out.back(), hits);
+        }
+        probes += count;
+    }
+    evalCache.AddStats(probes, hits);
+}
+
+void AIPlayer::KeepBest(std::vector<Node>& nodes) const {
+    // Sort a margin of candidates, since boards already kept through another move order are skipped
+    size_t candidates = std::min(nodes.size(), (size_t)beamWidth * 2);
+    std::partial_sort(nodes.begin(), nodes.begin() + candidates, nodes.end(),
+                      [](const Node& a, const Node& b) { return a.score > b.score; });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < candidates && kept < (size_t)beamWidth; i++) {
+        bool duplicate = false;
+        for (size_t j = 0; j < kept && !duplicate; j++) duplicate = nodes[j].hash == nodes[i].hash;
+        if (!duplicate) nodes[kept++] = nodes[i];
+    }
+    nodes.resize(kept);
+}
+
+void AIPlayer::ExpandLevel(int id, int workers) {
+    size_t share = (beam.size() + workers - 1) / workers;
+    for (int w = 0; w < workers; w++) workerOutput[w].clear();
+
+    // Hand the other shares to the parked workers
+    if (workers > 1) {
+        {
+            std::lock_guard<std::mutex> guard(workLock);
+            workPiece = id;
+            workCount = workers;
+            workShare = share;
+            workPending = workers - 1;
+            workGeneration++;
+        }
+        workReady.notify_all();
+    }
+
+    Expand(beam, 0, std::min(beam.size(), share), id, *enumerators[0], workerOutput[0]);
+
+    if (workers > 1) {
+        std::unique_lock<std::mutex> guard(workLock);
+        workDone.wait(guard, [this]() { return workPending == 0; });
+    }
+}
+
+void AIPlayer::WorkerLoop(int w) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> guard(workLock);
+    for (;;) {
+        workReady.wait(guard, [&]() { return stopping || workGeneration != seen; });
+        if (stopping) return;
+        seen = workGeneration;
+        if (w >= workCount) continue; // Not needed for this level
+
+        // The beam is only read while the level runs; each worker writes its own output
+        int id = workPiece;
+        size_t begin = std::min(beam.size(), w * workShare), end = std::min(beam.size(), begin + workShare);
+        guard.unlock();
+        Expand(beam, begin, end, id, *enumerators[w], workerOutput[w]);
+        guard.lock();
+
+        if (--workPending == 0) workDone.notify_one();
+    }
+}
+
+bool AIPlayer::Decide(const Simulation& game) {
+    auto start = std::chrono::steady_clock::now();
+    const Grid& grid = game.GetGrid();
+    const Block& current = game.GetCurrentBlock();
+
+    // Piece sequence: current, next, then the bag preview (read from a copy, Peek fills the queue)
+    Snapshot state;
+    game.Save(state);
+    int pieces[PieceBag::MAX_PREVIEW + 2];
+    pieces[0] = current.id;
+    pieces[1] = game.GetNextBlock().id;
+    for (int k = 2; k <= lookahead; k++) pieces[k] = state.bag.Peek(k - 2);
+
+    // Level 0: the current piece from where it is now
+    PlacementEnumerator& root = *enumerators[0];
+    int rootCount = root.Enumerate(grid, current);
+    if (rootCount == 0) return false;
+
+    Placement rootPlacements[PlacementEnumerator::MAX_PLACEMENTS];
+    std::copy(root.GetPlacements(), root.GetPlacements() + rootCount, rootPlacements);
+
+    Node start0;
+    memcpy(start0.rows, grid.GetRows(), sizeof(start0.rows));
+    start0.hash = grid.GetHash();
+    start0.lines = 0;
+    start0.score = 0;
+    start0.firstPlacement = -1;
+
+    beam.clear();
+    uint64_t hits = 0;
+    for (int p = 0; p < rootCount; p++) {
+        beam.emplace_back();
+        MakeChild(start0, current.id, rootPlacements[p], beam.back(), hits);
+        beam.back().firstPlacement = (int16_t)p;
+    }
+    evalCache.AddStats(rootCount, hits);
+    KeepBest(beam);
+
+    // Deeper levels: expand the beam with the following pieces, in parallel
+    for (int level = 1; level <= lookahead; level++) {
+        int workers = std::min(numThreads, (int)beam.size());
+        ExpandLevel(pieces[level], workers);
+
+        // Every line of play tops out: keep the previous level's beam
+        size_t total = 0;
+        for (int w = 0; w < workers; w++) total += workerOutput[w].size();
+        if (total == 0) break;
+
+        beam.clear();
+        for (int w = 0; w < workers; w++) beam.insert(beam.end(), workerOutput[w].begin(), workerOutput[w].end());
+        KeepBest(beam);
+    }
+
+    const Node& best = *std::max_element(beam.begin(), beam.end(),
+                                         [](const Node& a, const Node& b) { return a.score < b.score; });
+    const Placement& target = rootPlacements[best.firstPlacement];
+    targetRotation = target.rotation;
+    targetRow = target.row;
+    targetColumn = target.column;
+    hasTarget = true;
+    memcpy(decidedRows, grid.GetRows(), sizeof(decidedRows));
+
+    lastDecisionMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// --- CONTROL ---
+
+InputState AIPlayer::GetInput(const Simulation& game) {
+    InputState input = {};
+    input.currentScore = game.score;
+    if (game.gameOver) {
+        hasTarget = false;
+        return input;
+    }
+    if (ticksPerMove > 0 && game.GetTick() < lastMoveTick + ticksPerMove) return input;
+    lastMoveTick = game.GetTick();
+
+    // A changed grid means the last piece locked: plan the new one
+    const Grid& grid = game.GetGrid();
+    if (!hasTarget || memcmp(grid.GetRows(), decidedRows, sizeof(decidedRows)) != 0) {
+        if (!Decide(game)) { input.hardDrop = true; return input; }
+    }
+
+    // Find the target among the placements reachable from where the piece is now
+    const Block& block = game.GetCurrentBlock();
+    PlacementEnumerator& enumerator = *enumerators[0];
+    int index = -1;
+    for (int attempt = 0; attempt < 2 && index < 0; attempt++) {
+        // Gravity can carry the piece past a tuck; decide again from the current position once
+        if (attempt == 1 && !Decide(game)) break;
+        uint64_t targetKey = CellsKey(block.id, targetRotation, targetRow, targetColumn);
+        int count = enumerator.Enumerate(grid, block);
+        for (int i = 0; i < count && index < 0; i++) {
+            const Placement& p = enumerator.GetPlacement(i);
+            if (CellsKey(block.id, p.rotation, p.row, p.column) == targetKey) index = i;
+        }
+    }
+    if (index < 0) { input.hardDrop = true; return input; }
+
+    // One move per tick; once only straight drops remain, hard drop
+    PlacementMove path[MAX_PATH];
+    int length = std::min(enumerator.GetPath(index, path, MAX_PATH), MAX_PATH);
+    int firstSideways = 0;
+    while (firstSideways < length && path[firstSideways] == PLACEMENT_DOWN) firstSideways++;
+
+    if (firstSideways == length) input.hardDrop = true;
+    else if (path[0] == PLACEMENT_DOWN) input.down = true;
+    else if (path[0] == PLACEMENT_LEFT) input.left = true;
+    else if (path[0] == PLACEMENT_RIGHT) input.right = true;
+    else input.rotate = true;
+    return input;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file batch_simulation.cpp
+ * @brief Implementation of the BatchSimulation class.
+ */
+
+#include "../include/batch_simulation.hpp"
+#include <chrono>
+
+// --- CONSTRUCTOR ---
+
+BatchSimulation::BatchSimulation(int numBoards, uint32_t seed)
+    : numBoards(numBoards),
+      rows(numBoards * Grid::NUM_ROWS), pieceId(numBoards), pieceRotation(numBoards),
+      pieceRow(numBoards), pieceColumn(numBoards), nextPieceId(numBoards),
+      score(numBoards), level(numBoards), totalLinesCleared(numBoards), gameOver(numBoards),
+      bags(numBoards),
+      totalSteps(0), totalSeconds(0)
+{
+    // Spawn positions come from the same Block subclasses Simulation uses
+    for (int id = 0; id < 8; id++) {
+        Block spawn = CreateBlock(id);
+        spawnRow[id] = (int8_t)spawn.GetRow();
+        spawnColumn[id] = (int8_t)spawn.GetColumn();
+    }
+    Reset(seed);
+}
+
+// --- STATE MANAGEMENT ---
+
+void BatchSimulation::Reset(uint32_t seed) {
+    for (int board = 0; board < numBoards; board++) {
+        ResetBoard(board, seed + board);
+    }
+}
+
+void BatchSimulation::ResetBoard(int board, uint32_t seed) {
+    uint16_t* boardRows = &rows[board * Grid::NUM_ROWS];
+    for (int row = 0; row < Grid::NUM_ROWS; row++) {
+        boardRows[row] = Grid::EMPTY_ROW;
+    }
+
+    bags[board].Reset(seed);
+    score[board] = 0;
+    level[board] = 1;
+    totalLinesCleared[board] = 0;
+    gameOver[board] = 0;
+
+    SpawnPiece(board, bags[board].Next());
+    nextPieceId[board] = (uint8_t)bags[board].Next();
+}
+
+void BatchSimulation::SpawnPiece(int board, int id) {
+    pieceId[board] = (uint8_t)id;
+    pieceRotation[board] = 0;
+    pieceRow[board] = spawnRow[id];
+    pieceColumn[board] = spawnColumn[id];
+}
+
+// --- STEPPING ---
+
+int BatchSimulation::StepBatch(const BatchAction* actions) {
+    auto start = std::chrono::steady_clock::now();
+
+    int stepped = 0;
+    for (int board = 0; board < numBoards; board++) {
+        if (gameOver[board]) continue;
+        StepBoard(board, actions[board]);
+        stepped++;
+    }
+
+    totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    totalSteps += stepped;
+    return stepped;
+}
+
+double BatchSimulation::GetStepsPerSecond() const {
+    return totalSeconds > 0 ? totalSteps / totalSeconds : 0.0;
+}
+
+bool BatchSimulation::Fits(int board, int rotation, int row, int column) const {
+    return Grid::PieceFitsRows(&rows[board * Grid::NUM_ROWS], pieceId[board], rotation, row, column);
+}
+
+void BatchSimulation::StepBoard(int board, BatchAction action) {
+    // Same order as Simulation::HandleInput followed by a gravity tick
+    switch (action) {
+        case ACTION_LEFT:
+            if (Fits(board, pieceRotation[board], pieceRow[board], pieceColumn[board] - 1)) pieceColumn[board]--;
+            break;
+        case ACTION_RIGHT:
+            if (Fits(board, pieceRotation[board], pieceRow[board], pieceColumn[board] + 1)) pieceColumn[board]++;
+            break;
+        case ACTION_ROTATE: {
+            int nextRotation = (pieceRotation[board] + 1) % Block::NUM_ROTATIONS;
+            if (Fits(board, nextRotation, pieceRow[board], pieceColumn[board])) pieceRotation[board] = (uint8_t)nextRotation;
+            break;
+        }
+        case ACTION_SOFT_DROP:
+            if (MoveDown(board)) score[board] += 1; // 1 point for soft drop
+            break;
+        case ACTION_HARD_DROP: {
+            int distance = 0;
+            while (Fits(board, pieceRotation[board], pieceRow[board] + distance + 1, pieceColumn[board])) distance++;
+            pieceRow[board] += distance;
+            score[board] += 2 * distance; // 2 points per row for hard drop
+            LockPiece(board);
+            break;
+        }
+        default: break;
+    }
+
+    // Gravity
+    if (!gameOver[board]) MoveDown(board);
+}
+
+bool BatchSimulation::MoveDown(int board) {
+    if (!Fits(board, pieceRotation[board], pieceRow[board] + 1, pieceColumn[board])) {
+        LockPiece(board);
+        return false;
+    }
+    pieceRow[board]++;
+    return true;
+}
+
+void BatchSimulation::LockPiece(int board) {
+    uint16_t* boardRows = &rows[board * Grid::NUM_ROWS];
+    const std::array<uint8_t, 4>& masks = Block::GetRowMasks(pieceId[board], pieceRotation[board]);
+
+    for (int r = 0; r < 4; r++) {
+        if (masks[r] == 0) continue;
+        int gridRow = pieceRow[board] + r;
+        if (gridRow >= 0) {
+            boardRows[gridRow] |= (uint16_t)(masks[r] << Grid::ColumnBit(pieceColumn[board]));
+        }
+        else {
+            // Block locked above the visible grid area
+            gameOver[board] = 1;
+        }
+    }
+
+    if (!gameOver[board]) {
+        SpawnPiece(board, nextPieceId[board]);
+
+        // Immediate loss check upon spawning new block
+        if (!Fits(board, pieceRotation[board], pieceRow[board], pieceColumn[board])) {
+            gameOver[board] = 1;
+        }
+
+        nextPieceId[board] = (uint8_t)bags[board].Next();
+        int rowsCleared = __builtin_popcount(Grid::ClearFullRowMasks(boardRows, nullptr));
+
+        // Same scoring rules as Simulation::UpdateScore
+        score[board] += Simulation::GetLinePoints(rowsCleared, level[board]);
+        totalLinesCleared[board] += rowsCleared;
+        level[board] = Simulation::GetLevelForLines(totalLinesCleared[board]);
+    }
+}
\ No newline at end of file
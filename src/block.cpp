@@ -4,32 +4,85 @@
  */
 
 #include "../include/block.hpp"
+#include <type_traits>
 
-Block::Block() { 
-    rotationState = 0;
-    colors = GetCellColors();
-    rowOffset = 0;
-    columnOffset = 0;
-}
+// Shape tables indexed by [Block ID][Rotation State]. ID 0 is the empty cell and has no shape.
+// Blocks are plain values (id, rotation, offsets) that index into these tables,
+// so copying, moving and rotating a block never touches the heap.
+static constexpr std::array<Position, 4> shapes[8][Block::NUM_ROTATIONS] = {
+    // Empty (unused)
+    {{{Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0)}},
+     {{Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0)}},
+     {{Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0)}},
+     {{Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0)}}},
+    // 1: L Block
+    {{{Position(0, 2), Position(1, 0), Position(1, 1), Position(1, 2)}},
+     {{Position(0, 1), Position(1, 1), Position(2, 1), Position(2, 2)}},
+     {{Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 0)}},
+     {{Position(0, 0), Position(0, 1), Position(1, 1), Position(2, 1)}}},
+    // 2: J Block
+    {{{Position(0, 0), Position(1, 0), Position(1, 1), Position(1, 2)}},
+     {{Position(0, 1), Position(0, 2), Position(1, 1), Position(2, 1)}},
+     {{Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 2)}},
+     {{Position(0, 1), Position(1, 1), Position(2, 0), Position(2, 1)}}},
+    // 3: I Block
+    {{{Position(1, 0), Position(1, 1), Position(1, 2), Position(1, 3)}},
+     {{Position(0, 2), Position(1, 2), Position(2, 2), Position(3, 2)}},
+     {{Position(2, 0), Position(2, 1), Position(2, 2), Position(2, 3)}},
+     {{Position(0, 1), Position(1, 1), Position(2, 1), Position(3, 1)}}},
+    // 4: O Block (does not rotate visually, so all states are identical)
+    {{{Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)}},
+     {{Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)}},
+     {{Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)}},
+     {{Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)}}},
+    // 5: S Block
+    {{{Position(0, 1), Position(0, 2), Position(1, 0), Position(1, 1)}},
+     {{Position(0, 1), Position(1, 1), Position(1, 2), Position(2, 2)}},
+     {{Position(1, 1), Position(1, 2), Position(2, 0), Position(2, 1)}},
+     {{Position(0, 0), Position(1, 0), Position(1, 1), Position(2, 1)}}},
+    // 6: T Block
+    {{{Position(0, 1), Position(1, 0), Position(1, 1), Position(1, 2)}},
+     {{Position(0, 1), Position(1, 1), Position(1, 2), Position(2, 1)}},
+     {{Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 1)}},
+     {{Position(0, 1), Position(1, 0), Position(1, 1), Position(2, 1)}}},
+    // 7: Z Block
+    {{{Position(0, 0), Position(0, 1), Position(1, 1), Position(1, 2)}},
+     {{Position(0, 2), Position(1, 1), Position(1, 2), Position(2, 1)}},
+     {{Position(1, 0), Position(1, 1), Position(2, 1), Position(2, 2)}},
+     {{Position(0, 1), Position(1, 0), Position(1, 1), Position(2, 0)}}},
+};
 
-void Block::Draw(int offsetX, int offsetY, int dynamicCellSize, Color tint) {
-    std::vector<Position> tiles = GetCellPositions();
-    
-    for (Position item : tiles) {
-        //Retrieve the block's original color (e.g., Red for Z-Block)
-        Color finalColor = colors[id];
+// Row-mask and column-bottom forms of the shape tables, built at compile time.
+struct RowMaskTable {
+    std::array<uint8_t, 4> masks[8][Block::NUM_ROTATIONS];
+    std::array<int8_t, 4> bottoms[8][Block::NUM_ROTATIONS];
+};
 
-        // Apply alpha transparency if a tint is provided (e.g., for Ghost Piece)
-        if (tint.a > 0) {
-            finalColor.a = tint.a;
+static constexpr RowMaskTable BuildRowMasks() {
+    RowMaskTable table{};
+    for (int id = 0; id < 8; id++) {
+        for (int rotation = 0; rotation < Block::NUM_ROTATIONS; rotation++) {
+            table.bottoms[id][rotation] = {-1, -1, -1, -1};
+            for (const Position& cell : shapes[id][rotation]) {
+                table.masks[id][rotation][cell.row] |= (uint8_t)(1u << cell.column);
+                if (cell.row > table.bottoms[id][rotation][cell.column]) {
+                    table.bottoms[id][rotation][cell.column] = (int8_t)cell.row;
+                }
+            }
         }
-
-        DrawRectangle(item.column * dynamicCellSize + offsetX, 
-                      item.row * dynamicCellSize + offsetY, 
-                      dynamicCellSize - 1, 
-                      dynamicCellSize - 1, 
-                      finalColor);
     }
+    return table;
+}
+
+static constexpr RowMaskTable rowMasks = BuildRowMasks();
+
+static_assert(std::is_trivially_copyable<Block>::value, "Block must stay a plain value type");
+
+Block::Block() { 
+    id = 0;
+    rotationState = 0;
+    rowOffset = 0;
+    columnOffset = 0;
 }
 
 void Block::Move(int rows, int columns) {
@@ -37,23 +90,33 @@ void Block::Move(int rows, int columns) {
     columnOffset += columns;
 }
 
-std::vector<Position> Block::GetCellPositions() {
+std::array<Position, 4> Block::GetCellPositions() const {
     // Get local positions for the current rotation state
-    std::vector<Position> tiles = cells[rotationState];
-    std::vector<Position> movedTiles;
+    const std::array<Position, 4>& tiles = shapes[id][rotationState];
     
     // Apply the block's global offset to calculate absolute grid positions
-    for (Position item : tiles) {
-        Position newPos = Position(item.row + rowOffset, item.column + columnOffset);
-        movedTiles.push_back(newPos);
-    }
-    return movedTiles;
+    return {Position(tiles[0].row + rowOffset, tiles[0].column + columnOffset),
+            Position(tiles[1].row + rowOffset, tiles[1].column + columnOffset),
+            Position(tiles[2].row + rowOffset, tiles[2].column + columnOffset),
+            Position(tiles[3].row + rowOffset, tiles[3].column + columnOffset)};
+}
+
+const std::array<Position, 4>& Block::GetShape(int id, int rotation) {
+    return shapes[id][rotation];
+}
+
+const std::array<uint8_t, 4>& Block::GetRowMasks(int id, int rotation) {
+    return rowMasks.masks[id][rotation];
+}
+
+const std::array<int8_t, 4>& Block::GetColumnBottoms(int id, int rotation) {
+    return rowMasks.bottoms[id][rotation];
 }
 
 void Block::Rotate() {
     rotationState++;
-    // Cycle back to 0 if we exceed the number of defined rotation states (usually 4)
-    if (rotationState == (int)cells.size()) {
+    // Cycle back to 0 if we exceed the number of defined rotation states
+    if (rotationState == NUM_ROTATIONS) {
         rotationState = 0;
     }
 }
@@ -62,6 +125,6 @@ void Block::UndoRotation() {
     rotationState--;
     // Cycle back to the last state if we go below 0
     if (rotationState == -1) {
-        rotationState = (int)cells.size() - 1;
+        rotationState = NUM_ROTATIONS - 1;
     }
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 /**
  * @file blocks.cpp
  * @brief Implementation of specific Tetromino shapes (I, J, L, O, S, T, Z).
- * Each class defines the initial cell positions for all rotation states.
+ * Each class selects its shape (rotation tables live in block.cpp) and its spawn position.
  */
 
 #include "../include/block.hpp"
@@ -12,10 +12,6 @@ class LBlock : public Block {
 public:
     LBlock() {
        id = 1;
-       cells[0] = {Position(0, 2), Position(1, 0), Position(1, 1), Position(1, 2)};
-       cells[1] = {Position(0, 1), Position(1, 1), Position(2, 1), Position(2, 2)};
-       cells[2] = {Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 0)};
-       cells[3] = {Position(0, 0), Position(0, 1), Position(1, 1), Position(2, 1)};
        Move(0, 3); // Initial spawn position
     }    
 };
@@ -25,10 +21,6 @@ class JBlock : public Block {
 public:
     JBlock() {
        id = 2;
-       cells[0] = {Position(0, 0), Position(1, 0), Position(1, 1), Position(1, 2)};
-       cells[1] = {Position(0, 1), Position(0, 2), Position(1, 1), Position(2, 1)};
-       cells[2] = {Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 2)};
-       cells[3] = {Position(0, 1), Position(1, 1), Position(2, 0), Position(2, 1)};
        Move(0, 3);
     }    
 };
@@ -38,10 +30,6 @@ class IBlock : public Block {
 public:
     IBlock() {
        id = 3;
-       cells[0] = {Position(1, 0), Position(1, 1), Position(1, 2), Position(1, 3)};
-       cells[1] = {Position(0, 2), Position(1, 2), Position(2, 2), Position(3, 2)};
-       cells[2] = {Position(2, 0), Position(2, 1), Position(2, 2), Position(2, 3)};
-       cells[3] = {Position(0, 1), Position(1, 1), Position(2, 1), Position(3, 1)};
        Move(-1, 3); // Starts one row higher due to shape
     }    
 };
@@ -51,11 +39,6 @@ class OBlock : public Block {
 public:
     OBlock() {
        id = 4;
-       // O Block does not rotate visually, so all states are identical
-       cells[0] = {Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)};
-       cells[1] = {Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)};
-       cells[2] = {Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)};
-       cells[3] = {Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)};
        Move(0, 4);
     }   
 }; 
@@ -65,10 +48,6 @@ class SBlock : public Block {
 public:
     SBlock() {
        id = 5;
-       cells[0] = {Position(0, 1), Position(0, 2), Position(1, 0), Position(1, 1)};
-       cells[1] = {Position(0, 1), Position(1, 1), Position(1, 2), Position(2, 2)};
-       cells[2] = {Position(1, 1), Position(1, 2), Position(2, 0), Position(2, 1)};
-       cells[3] = {Position(0, 0), Position(1, 0), Position(1, 1), Position(2, 1)};
        Move(0, 3);
     }    
 };
@@ -78,10 +57,6 @@ class TBlock : public Block {
 public:
     TBlock() {
        id = 6;
-       cells[0] = {Position(0, 1), Position(1, 0), Position(1, 1), Position(1, 2)};
-       cells[1] = {Position(0, 1), Position(1, 1), Position(1, 2), Position(2, 1)};
-       cells[2] = {Position(1, 0), Position(1, 1), Position(1, 2), Position(2, 1)};
-       cells[3] = {Position(0, 1), Position(1, 0), Position(1, 1), Position(2, 1)};
        Move(0, 3);
     }    
 };
@@ -91,10 +66,20 @@ class ZBlock : public Block {
 public:
     ZBlock() {
        id = 7;
-       cells[0] = {Position(0, 0), Position(0, 1), Position(1, 1), Position(1, 2)};
-       cells[1] = {Position(0, 2), Position(1, 1), Position(1, 2), Position(2, 1)};
-       cells[2] = {Position(1, 0), Position(1, 1), Position(2, 1), Position(2, 2)};
-       cells[3] = {Position(0, 1), Position(1, 0), Position(1, 1), Position(2, 0)};
        Move(0, 3);
     }    
-};
\ No newline at end of file
+};
+
+// Creates a block of the given ID (1-7) at its spawn position.
+inline Block CreateBlock(int id) {
+    switch (id) {
+        case 1: return LBlock();
+        case 2: return JBlock();
+        case 3: return IBlock();
+        case 4: return OBlock();
+        case 5: return SBlock();
+        case 6: return TBlock();
+        case 7: return ZBlock();
+        default: return Block();
+    }
+}
\ No newline at end of file
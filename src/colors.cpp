@@ -20,9 +20,16 @@ const Color blue     = {13, 64, 216, 255};
 const Color lightBlue= {59, 85, 162, 255};
 const Color darkBlue = {44, 44, 127, 255};
 
+// Palette indexed by Block ID
+// Index 0: Background (darkGrey), Index 1: LBlock (Green?), etc.
+// Note: Ensure these match the IDs assigned in blocks.cpp logic
+static const Color cellColors[8] = {darkGrey, green, red, orange, yellow, purple, cyan, blue};
+
 std::vector<Color> GetCellColors() {
      // Returns the vector indexed by Block ID
-     // Index 0: Background (darkGrey), Index 1: LBlock (Green?), etc.
-     // Note: Ensure these match the IDs assigned in blocks.cpp logic
-     return {darkGrey, green, red, orange, yellow, purple, cyan, blue};
+     return std::vector<Color>(cellColors, cellColors + 8);
+}
+
+Color GetCellColor(int id) {
+     return cellColors[id];
 }
\ No newline at end of file
@@ -1,42 +1,56 @@
 /**
  * @file game.cpp
- * @brief Implementation of the Game class logic.
+ * @brief Implementation of the Game class rendering.
+ * The rules themselves live in Simulation (simulation.cpp); this file only draws its state.
  */
 
 #include "../include/game.hpp"
+#include "../include/colors.hpp"
 #include "raylib.h" 
-#include <algorithm>
-#include <cmath>
-#include <ctime>
 #include <cstdio> //Required for sprintf
 
-Game::Game(bool useArrowsInput) {
-    grid = Grid();
-    blocks = GetAllBlocks();
-    
-    // Initialize RNG with a random device seed
-    rng.seed(std::random_device{}()); 
+// --- LOCAL HELPER FUNCTIONS ---
+
+// Renders a block's cells. A tint with non-zero alpha overrides the block's alpha (e.g., for Ghost Piece).
+static void DrawBlock(const Block& block, int offsetX, int offsetY, int dynamicCellSize, Color tint = {0, 0, 0, 0}) {
+    std::array<Position, 4> tiles = block.GetCellPositions();
     
-    Reset();
-    useArrows = useArrowsInput;
-}
+    for (Position item : tiles) {
+        //Retrieve the block's original color (e.g., Red for Z-Block)
+        Color finalColor = GetCellColor(block.id);
 
-// --- LOGIC: Block Management ---
+        // Apply alpha transparency if a tint is provided (e.g., for Ghost Piece)
+        if (tint.a > 0) {
+            finalColor.a = tint.a;
+        }
 
-Block Game::GetRandomBlock() {
-    if (blocks.empty()) blocks = GetAllBlocks();
-    
-    // Select a random block using the instance-specific RNG
-    std::uniform_int_distribution<int> dist(0, blocks.size() - 1);
-    int randomIndex = dist(rng);
-    
-    Block block = blocks[randomIndex];
-    blocks.erase(blocks.begin() + randomIndex);
-    return block;
+        DrawRectangle(item.column * dynamicCellSize + offsetX, 
+                      item.row * dynamicCellSize + offsetY, 
+                      dynamicCellSize - 1, 
+                      dynamicCellSize - 1, 
+                      finalColor);
+    }
 }
 
-std::vector<Block> Game::GetAllBlocks() {
-    return {IBlock(), JBlock(), LBlock(), OBlock(), SBlock(), TBlock(), ZBlock()};
+// Renders every cell of the board using its color plane.
+static void DrawGrid(const Grid& grid, int offsetX, int offsetY, int dynamicCellSize) {
+    for (int row = 0; row < Grid::NUM_ROWS; row++) {
+        for (int column = 0; column < Grid::NUM_COLUMNS; column++) {
+            int cellValue = grid.GetCell(row, column);
+            
+            // Draw each cell using the dynamic size calculated in Game::Draw
+            // We subtract 1 from the size to create a small grid line effect
+            DrawRectangle(column * dynamicCellSize + offsetX, 
+                          row * dynamicCellSize + offsetY, 
+                          dynamicCellSize - 1, 
+                          dynamicCellSize - 1, 
+                          GetCellColor(cellValue));
+        }
+    }
+}
+
+Game::Game(bool useArrowsInput) : Simulation() {
+    useArrows = useArrowsInput;
 }
 
 // --- DRAWING ---
@@ -49,14 +63,14 @@ void Game::Draw(int offsetX, int offsetY, Font font) {
     int gridStartY = offsetY + (int)(20 * p);
 
     // 1. Draw Grid (Background)
-    grid.Drawn(gridStartX, gridStartY, dynamicCellSize); 
+    DrawGrid(grid, gridStartX, gridStartY, dynamicCellSize); 
 
     // 2. Draw Ghost Piece (Guide)
     DrawGhostPiece(offsetX, offsetY); 
 
     // 3. Draw Current Active Block
     if (!gameOver) {
-        currentBlock.Draw(gridStartX, gridStartY, dynamicCellSize); 
+        DrawBlock(currentBlock, gridStartX, gridStartY, dynamicCellSize); 
     }
 
     // 4. Draw User Interface (Score, Next Piece, etc.)
@@ -85,7 +99,7 @@ void Game::DrawUI(int offsetX, int offsetY, int cellSize, Font font, float p) {
     // Draw Next Piece Panel
     DrawRectangleRounded({uiX - (5*p), offsetY + (245 * p), 140 * p, 100 * p}, 0.3, 6, lightBlue);
     DrawTextEx(font, "Next", {uiX, offsetY + (210 * p)}, 30 * p, 2, WHITE);
-    nextBlock.Draw(uiX - (85*p), offsetY + (265 * p), cellSize);
+    DrawBlock(nextBlock, uiX - (85*p), offsetY + (265 * p), cellSize);
 
     // Draw Game Over Message
     if (gameOver) {
@@ -101,164 +115,10 @@ void Game::DrawGhostPiece(int offsetX, int offsetY) {
     int finalX = offsetX + (int)(20 * p);
     int finalY = offsetY + (int)(20 * p);
 
+    // Place a copy of the current block on its landing row
     Block ghostBlock = currentBlock;
-
-    // Simulate hard drop to find landing position
-    while (true) {
-        ghostBlock.Move(1, 0);
-        if (IsBlockOutside(ghostBlock) || !BlockFits(ghostBlock)) {
-            ghostBlock.Move(-1, 0); // Step back to valid position
-            break;
-        }
-    }
+    ghostBlock.Move(GetGhostRow() - ghostBlock.GetRow(), 0);
 
     // Draw with transparency (Alpha 50)
-    ghostBlock.Draw(finalX, finalY, dynamicCellSize, {255, 255, 255, 50}); 
-}
-
-// --- LOGIC: Collision & Movement ---
-
-bool Game::IsBlockOutside(Block block) {
-    std::vector<Position> tiles = block.GetCellPositions();
-    for(Position item: tiles){
-        if(grid.IsCellOutside(item.row, item.column)){
-            return true;
-        }
-    }
-    return false;
-}
-
-bool Game::BlockFits(Block block) {
-    std::vector<Position> tiles = block.GetCellPositions();
-    for (Position item : tiles) {
-        // Check if the cell is occupied in the grid
-        if (grid.IsCellEmpty(item.row, item.column) == false) {
-            return false;
-        }
-    }
-    return true;
-}
-
-void Game::HandleInput(InputState input) {
-    if (gameOver) { 
-        if (input.reset) { Reset(); } 
-        return; 
-    }
-
-    if (input.left)   MoveBlockLeft();
-    if (input.right)  MoveBlockRight();
-    if (input.rotate) RotateBlock();
-    
-    if (input.down) { 
-        if (MoveBlockDown()) {
-            UpdateScore(0, 1); // 1 point for soft drop
-        }
-    }
-}
-
-void Game::MoveBlockLeft() {
-    if(!gameOver){
-        currentBlock.Move(0, -1); 
-        if (IsBlockOutside(currentBlock) || !BlockFits(currentBlock)){
-            currentBlock.Move(0, 1); // Revert move
-        }
-    } 
-}
-
-void Game::MoveBlockRight(){
-    if(!gameOver){
-        currentBlock.Move(0, 1); 
-        if (IsBlockOutside(currentBlock) || !BlockFits(currentBlock)){
-            currentBlock.Move(0, -1); // Revert move
-        }
-    }
-}
-
-bool Game::MoveBlockDown(){ 
-    if(!gameOver){
-        currentBlock.Move(1, 0); 
-        if (IsBlockOutside(currentBlock) || !BlockFits(currentBlock)){
-            currentBlock.Move(-1, 0); // Revert move
-            LockBlock();
-            return false;
-        }
-        return true;
-    }
-    return false;
-}
-
-void Game::RotateBlock() {
-    if(!gameOver){
-        currentBlock.Rotate();
-        // Check collision after rotation, undo if invalid (Wall kick could be implemented here)
-        if(IsBlockOutside(currentBlock) || !BlockFits(currentBlock)){
-            currentBlock.UndoRotation();
-        }
-    }
-}
-
-// --- LOGIC: Game State & Scoring ---
-
-void Game::LockBlock() {
-    std::vector<Position> tiles = currentBlock.GetCellPositions();
-    for (Position item: tiles){
-        if(item.row >= 0) {
-            grid.grid[item.row][item.column] = currentBlock.id;
-        }
-        else {
-            // Block locked above the visible grid area
-            gameOver = true;
-        }
-    }
-
-    if (!gameOver) {
-        currentBlock = nextBlock;
-        
-        // Immediate loss check upon spawning new block
-        if(!BlockFits(currentBlock)) {
-            gameOver = true;
-        }
-        
-        nextBlock = GetRandomBlock();
-        int rowsCleared = grid.ClearFullRows();
-        UpdateScore(rowsCleared, 0);
-    }
-}
-
-double Game::GetSpeed() {
-    // Increase speed as level increases (capped at 0.05s)
-    return (double)fmax(0.05, 0.8 - ((level - 1) * 0.07)); 
-}
-
-void Game::Reset(int seed) {
-    grid.Initalize();
-    blocks = GetAllBlocks();
-    
-    // Seed RNG: Use provided seed (Multiplayer) or Time (Singleplayer)
-    if (seed != -1) {
-        rng.seed(seed);
-    } else {
-        rng.seed((unsigned int)time(NULL));
-    }
-
-    currentBlock = GetRandomBlock();
-    nextBlock = GetRandomBlock();
-    score = 0;
-    level = 1;
-    totalLinesCleared = 0;
-    gameOver = false;
-}
-
-void Game::UpdateScore(int linesCleared, int moveDownPoints) {
-    // Classic Tetris scoring system
-    switch (linesCleared) {
-        case 1: score += 100 * level; break;
-        case 2: score += 300 * level; break;
-        case 3: score += 500 * level; break;
-        case 4: score += 800 * level; break;
-        default: break;
-    }
-    score += moveDownPoints; 
-    totalLinesCleared += linesCleared;
-    level = 1 + (totalLinesCleared / 10);
+    DrawBlock(ghostBlock, finalX, finalY, dynamicCellSize, {255, 255, 255, 50}); 
 }
\ No newline at end of file
@@ -5,51 +5,45 @@
 
 #include "../include/grid.hpp"
 #include <iostream>
-#include "../include/colors.hpp"
+
+// SIMD row scan: AVX2 or SSE2 when the compiler targets them (SSE2 is always present on x86-64).
+// Define TETRIS_NO_SIMD to force the scalar path.
+#if !defined(TETRIS_NO_SIMD) && defined(__AVX2__)
+    #include <immintrin.h>
+    #define GRID_USE_AVX2
+#elif !defined(TETRIS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define GRID_USE_SSE2
+#endif
+#include "../include/block.hpp"
+#include "../include/zobrist.hpp"
 
 Grid::Grid() {
-    numColums = 10;
-    numRows = 20;
     Initalize();
-    colors = GetCellColors();
-    cellSize = 30; //Default fallback size, overridden in Draw
 }
 
 void Grid::Initalize() {
-    // Fill the grid with zeros (empty cells)
+    // Every row starts with only the side walls set (no blocks)
     for (int row = 0; row < numRows; row++) {
-        for (int column = 0; column < numColums; column++) {
-            grid[row][column] = 0;
-        }
+        rows[row] = EMPTY_ROW;
+        cellColors[row] = 0;
     }
+    for (int column = 0; column < numColums; column++) {
+        columnMasks[column] = 0;
+    }
+    hash = 0;
 }
 
 void Grid::Print() {
     // Debug output to console
     for (int row = 0; row < numRows; row++) {
         for (int column = 0; column < numColums; column++) {
-            std::cout << grid[row][column] << " ";
+            std::cout << GetCell(row, column) << " ";
         }
         std::cout << std::endl;
     }
 }
 
-void Grid::Drawn(int offsetX, int offsetY, int dynamicCellSize) {
-    for (int row = 0; row < numRows; row++) {
-        for (int column = 0; column < numColums; column++) {
-            int cellValue = grid[row][column];
-            
-            // Draw each cell using the dynamic size calculated in Game::Draw
-            // We subtract 1 from the size to create a small grid line effect
-            DrawRectangle(column * dynamicCellSize + offsetX, 
-                          row * dynamicCellSize + offsetY, 
-                          dynamicCellSize - 1, 
-                          dynamicCellSize - 1, 
-                          colors[cellValue]);
-        }
-    }
-}
-
 bool Grid::IsCellOutside(int row, int column) {
     if (row >= 0 && row < numRows && column >= 0 && column < numColums) {
         return false; // Inside valid bounds
@@ -69,42 +63,155 @@ bool Grid::IsCellEmpty(int row, int column) {
     if (row < 0) return true; 
 
     // 4. Check collision with existing blocks
-    return (grid[row][column] == 0);
+    return (rows[row] & (1u << ColumnBit(column))) == 0;
+}
+
+bool Grid::PieceFits(int id, int rotation, int row, int column) const {
+    return PieceFitsRows(rows, id, rotation, row, column);
+}
+
+bool Grid::PieceFitsRows(const uint16_t* rows, int id, int rotation, int row, int column) {
+    // A shift below zero means the piece starts left of the wall bits, so some cell is outside
+    int shift = ColumnBit(column);
+    if (shift < 0) return false;
+
+    const std::array<uint8_t, 4>& masks = Block::GetRowMasks(id, rotation);
+    for (int r = 0; r < 4; r++) {
+        if (masks[r] == 0) continue;
+
+        // Rows above the ceiling or below the floor are outside the grid
+        int gridRow = row + r;
+        if (gridRow < 0 || gridRow >= numRows) return false;
+
+        // Cells past the right wall overflow the 16-bit row; walls and blocks are both set bits
+        uint32_t shifted = (uint32_t)masks[r] << shift;
+        if (shifted > FULL_ROW || (shifted & rows[gridRow]) != 0) return false;
+    }
+    return true;
+}
+
+int Grid::GetCell(int row, int column) const {
+    return (cellColors[row] >> (column * 3)) & 0x7;
+}
+
+void Grid::SetCell(int row, int column, int id) {
+    uint32_t shift = column * 3;
+    cellColors[row] = (cellColors[row] & ~(0x7u << shift)) | ((uint32_t)id << shift);
+
+    // Toggle the cell's key only when its occupancy actually changes
+    bool wasFilled = (rows[row] >> ColumnBit(column)) & 1;
+    if (wasFilled != (id != 0)) hash ^= Zobrist::Cell(row, column);
+
+    if (id != 0) {
+        rows[row] |= (uint16_t)(1u << ColumnBit(column));
+        columnMasks[column] |= (1u << row);
+    }
+    else {
+        rows[row] &= (uint16_t)~(1u << ColumnBit(column));
+        columnMasks[column] &= ~(1u << row);
+    }
+}
+
+int Grid::NextOccupiedRow(int column, int row) const {
+    // Rows above the ceiling are always empty, so start scanning at row 0
+    if (row < 0) row = 0;
+    if (row >= numRows) return numRows;
+
+    uint32_t below = columnMasks[column] >> row;
+    return below ? row + __builtin_ctz(below) : numRows;
+}
+
+int Grid::GetDropDistance(int id, int rotation, int row, int column) const {
+    const std::array<int8_t, 4>& bottoms = Block::GetColumnBottoms(id, rotation);
+    int distance = numRows;
+
+    // Tetromino cells are contiguous in each column, so only the lowest cell of each column can land
+    for (int c = 0; c < 4; c++) {
+        if (bottoms[c] < 0) continue;
+        int bottomRow = row + bottoms[c];
+        int gap = NextOccupiedRow(column + c, bottomRow + 1) - bottomRow - 1;
+        if (gap < distance) distance = gap;
+    }
+    return distance;
+}
+
+int Grid::GetColumnHeight(int column) const {
+    return columnMasks[column] ? numRows - __builtin_ctz(columnMasks[column]) : 0;
 }
 
 int Grid::ClearFullRows() {
-    int completed = 0;
-    
-    // Iterate from bottom to top
-    for (int row = numRows - 1; row >= 0; row--) {
-        if (IsRowFull(row)) {
-            ClearRow(row);
-            completed++;
-        }
-        else if (completed > 0) {
-            // If rows were cleared below, move the current row down
-            MoveRowDown(row, completed);
+    uint32_t clearedRows = FindFullRows(rows);
+    if (clearedRows == 0) return 0;
+
+    // Only the rows from the top down to the lowest cleared one change: rehash that band
+    int band = 32 - __builtin_clz(clearedRows);
+    hash ^= Zobrist::Rows(rows, band);
+    ClearFullRowMasks(rows, cellColors);
+    hash ^= Zobrist::Rows(rows, band);
+    int completed = __builtin_popcount(clearedRows);
+
+    // Update the column summary: each cleared row is removed and the bits above it shift down one row.
+    // Processing top to bottom keeps the indices of the remaining cleared rows unchanged.
+    while (clearedRows) {
+        int row = __builtin_ctz(clearedRows);
+        clearedRows &= clearedRows - 1;
+        uint32_t above = (1u << row) - 1;
+        for (int column = 0; column < numColums; column++) {
+            uint32_t mask = columnMasks[column];
+            columnMasks[column] = (mask & ~(above | (1u << row))) | ((mask & above) << 1);
         }
     }
     return completed;
 }
 
-bool Grid::IsRowFull(int row) {
-    for (int column = 0; column < numColums; column++) {
-        if (grid[row][column] == 0) return false;
+uint32_t Grid::FindFullRows(const uint16_t* rows) {
+    static_assert(numRows == 20, "SIMD row scan is laid out for 20 rows");
+
+#if defined(GRID_USE_AVX2)
+    // Two overlapping 16-row loads (rows 0-15 and 4-19), compared against FULL_ROW in one go.
+    // packs_epi16 works per 128-bit lane, so the byte mask comes out as
+    // [rows 0-7 | rows 4-11 | rows 8-15 | rows 12-19].
+    const __m256i full = _mm256_set1_epi16((short)FULL_ROW);
+    __m256i low = _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)rows), full);
+    __m256i high = _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(rows + 4)), full);
+    uint32_t bytes = (uint32_t)_mm256_movemask_epi8(_mm256_packs_epi16(low, high));
+    return (bytes & 0xFF) | ((bytes >> 8) & 0xFF00) | (((bytes >> 28) & 0xF) << 16);
+#elif defined(GRID_USE_SSE2)
+    // Three 8-row loads (rows 0-7, 8-15 and the overlapping 12-19), narrowed to one byte per row.
+    const __m128i full = _mm_set1_epi16((short)FULL_ROW);
+    __m128i r0 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)rows), full);
+    __m128i r1 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(rows + 8)), full);
+    __m128i r2 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(rows + 12)), full);
+    uint32_t first = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(r0, r1));
+    uint32_t last = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(r2, r2));
+    return first | (((last >> 4) & 0xF) << 16);
+#else
+    uint32_t fullRows = 0;
+    for (int row = 0; row < numRows; row++) {
+        if (rows[row] == FULL_ROW) fullRows |= (1u << row);
     }
-    return true;
+    return fullRows;
+#endif
 }
 
-void Grid::ClearRow(int row) {
-    for (int column = 0; column < numColums; column++) {
-        grid[row][column] = 0;
+uint32_t Grid::ClearFullRowMasks(uint16_t* rows, uint32_t* colors) {
+    // Check every row at once; most locks clear nothing
+    uint32_t clearedRows = FindFullRows(rows);
+    if (clearedRows == 0) return 0;
+
+    // Single compaction pass from bottom to top: every row is copied to the write slot,
+    // but the slot only advances past surviving rows, so full rows get overwritten.
+    int write = numRows - 1;
+    for (int row = numRows - 1; row >= 0; row--) {
+        rows[write] = rows[row];
+        if (colors) colors[write] = colors[row];
+        write -= (int)(~clearedRows >> row) & 1;
     }
-}
 
-void Grid::MoveRowDown(int row, int numRows) {
-    for (int column = 0; column < numColums; column++) {
-        grid[row + numRows][column] = grid[row][column]; 
-        grid[row][column] = 0;
+    // The rows freed at the top become empty
+    for (int row = 0; row <= write; row++) {
+        rows[row] = EMPTY_ROW;
+        if (colors) colors[row] = 0;
     }
+    return clearedRows;
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * @file input_channel.cpp
+ * @brief Implementation of the InputChannel class.
+ */
+
+#include "../include/input_channel.hpp"
+#include <algorithm>
+
+// --- CONSTRUCTOR ---
+
+InputChannel::InputChannel() : frameCount(0), ackedFrame(0), sentAck(0), ackDue(false), round(0) {}
+
+void InputChannel::Reset(uint8_t newRound) {
+    inputs.clear();
+    checksums.clear();
+    frameCount = 0;
+    ackedFrame = 0;
+    sentAck = 0;
+    ackDue = false;
+    round = newRound;
+}
+
+// --- STREAM ---
+
+void InputChannel::AddInput(uint32_t frame, InputState input) {
+    bool idle = !(input.left || input.right || input.down || input.rotate || input.hardDrop || input.reset);
+    if (idle || frame < frameCount) return;
+    inputs.push_back({ frame, input });
+    frameCount = frame + 1;
+}
+
+void InputChannel::SetFrameCount(uint32_t frames) {
+    frameCount = std::max(frameCount, frames);
+}
+
+void InputChannel::AddChecksum(uint32_t frame, uint64_t checksum) {
+    if (frame < ackedFrame || (!checksums.empty() && frame <= checksums.back().frame)) return;
+    checksums.push_back({ frame, checksum });
+    if (checksums.size() > MAX_PENDING_CHECKSUMS) checksums.pop_front();
+}
+
+// --- NETWORK ---
+
+void InputChannel::OnWindow(const NetMessage& window, uint32_t ack) {
+    // Acknowledged inputs and checksums are never sent again
+    if (window.ack > ackedFrame) {
+        ackedFrame = std::min(window.ack, frameCount);
+        while (!inputs.empty() && inputs.front().frame < ackedFrame) inputs.pop_front();
+        while (!checksums.empty() && checksums.front().frame < ackedFrame) checksums.pop_front();
+    }
+
+    // The sender's window still starts before our ack: it never got it
+    if (window.frame < ack) ackDue = true;
+}
+
+bool InputChannel::Queue(PacketBatcher& batcher, ENetPeer* peer, PacketBatch& batch, uint32_t ack) {
+    if (frameCount <= ackedFrame && ack == sentAck && !ackDue) return false;
+
+    // Checksums first: the receiver must have them before the window confirms their frames
+    for (const FrameChecksum& sample : checksums) {
+        batcher.Queue(peer, batch, WireProtocol::MakeChecksum(round, sample.frame, sample.checksum), CHANNEL_FRAMES);
+    }
+
+    NetMessage window = WireProtocol::Make(PACKET_INPUT);
+    window.round = round;
+    window.ack = ack;
+    window.frame = ackedFrame;
+    window.endFrame = frameCount;
+    for (const FrameInput& input : inputs) {
+        // A full window stops right before the first input it cannot list
+        if (window.inputCount == MAX_WINDOW_INPUTS) {
+            window.endFrame = input.frame;
+            break;
+        }
+        window.inputs[window.inputCount++] = input;
+    }
+    batcher.Queue(peer, batch, window, CHANNEL_FRAMES);
+
+    sentAck = ack;
+    ackDue = false;
+    return true;
+}
@@ -1,9 +1,9 @@
 #include "../include/input_handler.hpp"
 
 float InputHandler::dasDelay = 0.20f;
-float InputHandler::timers[2][3] = {0};
+double InputHandler::timers[2][3] = {0};
 
-bool InputHandler::HandleKeyWithDAS(int key1, int key2, int playerIdx, int timerIdx, float interval, bool inputBlocked) {
+bool InputHandler::HandleKeyWithDAS(int key1, int key2, int playerIdx, int timerIdx, float interval, bool inputBlocked, double now) {
     
     if (inputBlocked) return false;
     
@@ -11,12 +11,12 @@ bool InputHandler::HandleKeyWithDAS(int key1, int key2, int playerIdx, int timer
     bool isDown = IsKeyDown(key1) || (key2 != KEY_NULL && IsKeyDown(key2));
 
     if (isPressed) {
-        timers[playerIdx][timerIdx] = GetTime() + dasDelay;
+        timers[playerIdx][timerIdx] = now + dasDelay;
         return true;
     }
     if (isDown) {
-        if (GetTime() >= timers[playerIdx][timerIdx]) {
-            timers[playerIdx][timerIdx] = GetTime() + interval;
+        if (now >= timers[playerIdx][timerIdx]) {
+            timers[playerIdx][timerIdx] = now + interval;
             return true;
         }
     }
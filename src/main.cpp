@@ -13,7 +13,7 @@
 #include "../include/game_types.hpp"
 #include "../include/ui_manager.hpp"
 #include "../include/input_handler.hpp"
-#include "../include/utils.hpp"
+#include "../include/ai_player.hpp"
 #include <iostream>
 #include <string>
 #include <string.h>
@@ -33,6 +33,10 @@ int letterCount = 9;
 bool useSameSeeds = true;      
 bool showDualSeedMenu = false; 
 
+// --- Bot Configuration ---
+// In local dual mode, [B] hands player 2 over to the built-in AI.
+bool p2IsBot = false;
+
 // --- DAS Configuration ---
 // 'dasInterval' defines the repetition speed when a key is held down.
 float dasInterval = 0.06f; 
@@ -76,6 +80,8 @@ int main() {
     Game gameP1(false); // Player 1 in Dual/Online mode (WASD)
     Game gameP2(true);  // Player 2 in Dual/Online mode (Arrows)
     NetworkManager net; 
+    AIPlayer bot;       // Drives Player 2 in Dual mode when p2IsBot is set
+    bot.ticksPerMove = 4;
     Menu menu; 
     GameState currentState = MENU;
 
@@ -135,7 +141,8 @@ int main() {
                     currentState = DUAL_PLAYING; 
                     unsigned int s = (unsigned int)time(NULL); 
                     gameP1.Reset(s); 
-                    gameP2.Reset(s); 
+                    gameP2.Reset(s);
+                    bot.Reset();
                     
                     SetWindowSize(winW_Dual, winH); 
                     countdownTimer = 3.5f; 
@@ -147,7 +154,8 @@ int main() {
                     showDualSeedMenu = false; 
                     currentState = DUAL_PLAYING; 
                     gameP1.Reset((unsigned int)time(NULL)); 
-                    gameP2.Reset((unsigned int)time(NULL) + 100); 
+                    gameP2.Reset((unsigned int)time(NULL) + 100);
+                    bot.Reset();
                     
                     SetWindowSize(winW_Dual, winH); 
                     countdownTimer = 3.5f; 
@@ -273,7 +281,7 @@ int main() {
             if (currentState == ONLINE_PLAYING) {
                 net.Update(gameP1, gameP2, isPaused, countdownTimer, useSameSeeds);
                 
-                if (!net.isConnected && net.role == CLIENT && !net.opponentQuit) {
+                if (!net.isConnected && net.role == CLIENT && !net.opponentQuit && !net.isRedirecting) {
                     static double lastRetry = 0;
                     if (GetTime() - lastRetry > 1.0) { 
                         net.StartClient(lastConnectedIP, 1234); 
@@ -333,25 +341,23 @@ int main() {
                     if (IsKeyPressed(KEY_R)) { net.remoteStartedNewGame = false; gameP1.Reset(); gameP2.Reset(); }
                 }
                 else {
+                    InputState localIn = {};
                     if (!anyReqActive && !showMenuConfirm && countdownTimer <= 0 && !gameP1.gameOver) {
                         if (IsKeyPressed(KEY_P)) { if (isPaused) net.SendRequest(PACKET_RESUME_REQ); else net.SendRequest(PACKET_PAUSE_REQ); }
                         if (IsKeyPressed(KEY_R)) net.SendRequest(PACKET_RESTART_REQ);
                         
-                        InputState localIn = { 
-                            InputHandler::HandleKeyWithDAS(KEY_LEFT, KEY_A, 0, 0, dasInterval, inputBlocked), 
-                            InputHandler::HandleKeyWithDAS(KEY_RIGHT, KEY_D, 0, 1, dasInterval, inputBlocked), 
-                            InputHandler::HandleKeyWithDAS(KEY_DOWN, KEY_S, 0, 2, dasInterval, inputBlocked), 
+                        localIn = { 
+                            InputHandler::HandleKeyWithDAS(KEY_LEFT, KEY_A, 0, 0, dasInterval, inputBlocked, gameP1.clock.GetTime()), 
+                            InputHandler::HandleKeyWithDAS(KEY_RIGHT, KEY_D, 0, 1, dasInterval, inputBlocked, gameP1.clock.GetTime()), 
+                            InputHandler::HandleKeyWithDAS(KEY_DOWN, KEY_S, 0, 2, dasInterval, inputBlocked, gameP1.clock.GetTime()), 
                             !inputBlocked && (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)), 
+                            !inputBlocked && IsKeyPressed(KEY_SPACE), 
                             false, gameP1.score 
                         };
-                        net.SendInput(localIn); gameP1.HandleInput(localIn);
                     }
                     
-                    if (net.role == SERVER && !isPaused && !anyReqActive && countdownTimer <= 0 && !gameP1.gameOver) {
-                        if(Utils::EventTriggered(gameP1.GetSpeed(), timerStopped)) { 
-                            gameP1.MoveBlockDown(); gameP2.MoveBlockDown(); net.SendTick(); 
-                        }
-                    }
+                    // Each board runs its own gravity tick by tick; the local one never waits for the network
+                    net.StepLocal(gameP1, localIn, GetFrameTime(), timerStopped || anyReqActive);
                     
                     gameP1.Draw(0, 0, font); gameP2.Draw(winW_Single, 0, font);
 
@@ -413,6 +419,9 @@ int main() {
                         }
                     }
                 }
+
+                // Everything queued this frame leaves as one packet per network tick
+                net.Flush(GetFrameTime());
             } 
             // --- OFFLINE MODES ---
             else {
@@ -420,15 +429,15 @@ int main() {
                     if (!showMenuConfirm && !showRestartConfirm && IsKeyPressed(KEY_P)) isPaused = !isPaused;
                     
                     InputState soloIn = { 
-                        InputHandler::HandleKeyWithDAS(KEY_LEFT, KEY_A, 0, 0, dasInterval, inputBlocked), 
-                        InputHandler::HandleKeyWithDAS(KEY_RIGHT, KEY_D, 0, 1, dasInterval, inputBlocked), 
-                        InputHandler::HandleKeyWithDAS(KEY_DOWN, KEY_S, 0, 2, dasInterval, inputBlocked), 
+                        InputHandler::HandleKeyWithDAS(KEY_LEFT, KEY_A, 0, 0, dasInterval, inputBlocked, gameSolo.clock.GetTime()), 
+                        InputHandler::HandleKeyWithDAS(KEY_RIGHT, KEY_D, 0, 1, dasInterval, inputBlocked, gameSolo.clock.GetTime()), 
+                        InputHandler::HandleKeyWithDAS(KEY_DOWN, KEY_S, 0, 2, dasInterval, inputBlocked, gameSolo.clock.GetTime()), 
                         !inputBlocked && (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)), 
+                        !inputBlocked && IsKeyPressed(KEY_SPACE), 
                         false, gameSolo.score 
                     };
                     
-                    gameSolo.HandleInput(soloIn); 
-                    if(Utils::EventTriggered(gameSolo.GetSpeed(), timerStopped)) gameSolo.MoveBlockDown();
+                    gameSolo.Update(GetFrameTime(), soloIn, timerStopped);
                     gameSolo.Draw(0, 0, font);
 
                     if (gameSolo.gameOver) {
@@ -454,30 +463,34 @@ int main() {
                     if (!showMenuConfirm && !showRestartConfirm && IsKeyPressed(KEY_P)) isPaused = !isPaused;
                     
                     InputState p1In = { 
-                        InputHandler::HandleKeyWithDAS(KEY_A, KEY_NULL, 0, 0, dasInterval, inputBlocked), 
-                        InputHandler::HandleKeyWithDAS(KEY_D, KEY_NULL, 0, 1, dasInterval, inputBlocked), 
-                        InputHandler::HandleKeyWithDAS(KEY_S, KEY_NULL, 0, 2, dasInterval, inputBlocked), 
+                        InputHandler::HandleKeyWithDAS(KEY_A, KEY_NULL, 0, 0, dasInterval, inputBlocked, gameP1.clock.GetTime()), 
+                        InputHandler::HandleKeyWithDAS(KEY_D, KEY_NULL, 0, 1, dasInterval, inputBlocked, gameP1.clock.GetTime()), 
+                        InputHandler::HandleKeyWithDAS(KEY_S, KEY_NULL, 0, 2, dasInterval, inputBlocked, gameP1.clock.GetTime()), 
                         !inputBlocked && IsKeyPressed(KEY_W), 
+                        !inputBlocked && IsKeyPressed(KEY_SPACE), 
                         false, gameP1.score 
                     };
                     InputState p2In = { 
-                        InputHandler::HandleKeyWithDAS(KEY_LEFT, KEY_NULL, 1, 0, dasInterval, inputBlocked), 
-                        InputHandler::HandleKeyWithDAS(KEY_RIGHT, KEY_NULL, 1, 1, dasInterval, inputBlocked), 
-                        InputHandler::HandleKeyWithDAS(KEY_DOWN, KEY_NULL, 1, 2, dasInterval, inputBlocked), 
+                        InputHandler::HandleKeyWithDAS(KEY_LEFT, KEY_NULL, 1, 0, dasInterval, inputBlocked, gameP2.clock.GetTime()), 
+                        InputHandler::HandleKeyWithDAS(KEY_RIGHT, KEY_NULL, 1, 1, dasInterval, inputBlocked, gameP2.clock.GetTime()), 
+                        InputHandler::HandleKeyWithDAS(KEY_DOWN, KEY_NULL, 1, 2, dasInterval, inputBlocked, gameP2.clock.GetTime()), 
                         !inputBlocked && IsKeyPressed(KEY_UP), 
+                        !inputBlocked && IsKeyPressed(KEY_ENTER), 
                         false, gameP2.score 
                     };
-                    
-                    gameP1.HandleInput(p1In); 
-                    gameP2.HandleInput(p2In);
-                    
-                    if(Utils::EventTriggered(gameP1.GetSpeed(), timerStopped)) { 
-                        gameP1.MoveBlockDown(); 
-                        gameP2.MoveBlockDown(); 
+                    if (!showMenuConfirm && !showRestartConfirm && IsKeyPressed(KEY_B)) { p2IsBot = !p2IsBot; bot.Reset(); }
+                    if (p2IsBot) {
+                        p2In = { false, false, false, false, false, false, gameP2.score };
+                        if (!inputBlocked) p2In = bot.GetInput(gameP2);
                     }
                     
+                    // Each board runs on its own fixed-tick clock and gravity
+                    gameP1.Update(GetFrameTime(), p1In, timerStopped); 
+                    gameP2.Update(GetFrameTime(), p2In, timerStopped);
+                    
                     gameP1.Draw(0, 0, font); 
                     gameP2.Draw(winW_Single, 0, font);
+                    if (p2IsBot) DrawTextEx(font, "BOT [B]", {winW_Single + 20*p, 10*p}, 18*p, 2, ORANGE);
 
                     // Game Over Screen (Local Dual)
                     if (gameP1.gameOver && gameP2.gameOver) {
@@ -497,7 +510,8 @@ int main() {
                         if (UIManager::DrawConfirmButton(font, "RESTART (R)", restartRect, p) || IsKeyPressed(KEY_R)) {
                             unsigned int s = (unsigned int)time(NULL); 
                             gameP1.Reset(s); 
-                            gameP2.Reset(useSameSeeds ? s : s + 9999); 
+                            gameP2.Reset(useSameSeeds ? s : s + 9999);
+                            bot.Reset();
                             countdownTimer = 3.5f; 
                         }
                         if (UIManager::DrawConfirmButton(font, "MENU (M)", menuRect, p) || IsKeyPressed(KEY_M)) {
@@ -535,9 +549,9 @@ int main() {
                         } else {
                             gameP1.Reset(s); 
                             gameP2.Reset(useSameSeeds ? s : s + 9999);
+                            bot.Reset();
                         }
                         countdownTimer = 3.5f; 
-                        Utils::EventTriggered(0, true); 
                     }
                     showMenuConfirm = showRestartConfirm = false;
                 }
@@ -0,0 +1,549 @@
+/**
+ * @file match_server.cpp
+ * @brief Implementation of the MatchServer class.
+ */
+
+// 1. Windows-specific protection definitions
+#if defined(_WIN32)
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+#include <enet/enet.h>
+#include "../include/match_server.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+
+// Server bot: a light search on the server thread, moving at a human pace
+static const int BOT_LOOKAHEAD = 1;
+static const int BOT_BEAM_WIDTH = 8;
+static const int BOT_TICKS_PER_MOVE = 4;
+
+// --- CONSTRUCTOR / DESTRUCTOR ---
+
+MatchServer::MatchServer() : host(nullptr), waiting(nullptr), waitingTime(0), seedCounter(0), nextMatchId(1), framesSimulated(0) {
+    if (enet_initialize() != 0) {
+        std::cerr << "[Server] Error initializing ENet!\n";
+    }
+}
+
+MatchServer::~MatchServer() {
+    Stop();
+    enet_deinitialize();
+}
+
+// --- CONNECTION MANAGEMENT ---
+
+bool MatchServer::Start(int port, int maxClients) {
+    Stop();
+
+    ENetAddress address;
+    address.host = ENET_HOST_ANY;
+    address.port = (enet_uint16)port;
+
+    // Control and frame channels, no bandwidth limits (same as a hosting player)
+    host = enet_host_create(&address, (size_t)maxClients, CHANNEL_COUNT, 0, 0);
+    framesSimulated = 0;
+    return host != nullptr;
+}
+
+void MatchServer::Stop() {
+    if (!host) return;
+
+    for (const std::unique_ptr<Match>& match : matches) {
+        for (ENetPeer* player : match->players) Send(player, WireProtocol::Make(PACKET_QUIT));
+        FlushMatch(*match);
+        for (ENetPeer* player : match->players) {
+            if (player) enet_peer_disconnect(player, 0);
+        }
+        ReleaseSpectators(*match);
+    }
+    if (waiting) enet_peer_disconnect(waiting, 0);
+    for (const PendingTicket& pending : tickets) {
+        for (ENetPeer* player : pending.players) {
+            if (player) enet_peer_disconnect(player, 0);
+        }
+    }
+    enet_host_flush(host);
+    enet_host_destroy(host);
+
+    host = nullptr;
+    waiting = nullptr;
+    matches.clear();
+    tickets.clear();
+}
+
+void MatchServer::Send(ENetPeer* peer, const NetMessage& message) {
+    if (!peer) return; // The bot's side
+    Match* match = (Match*)peer->data;
+    int slot = match ? GetSlot(*match, peer) : -1;
+    if (slot >= 0) batcher.Queue(peer, match->outbox[slot], message);
+    else batcher.SendNow(peer, message);
+}
+
+void MatchServer::FlushMatch(Match& match) {
+    for (int slot = 0; slot < 2; slot++) {
+        if (!match.players[slot]) continue; // The bot plays the server's board directly
+        batcher.Send(match.players[slot], match.outbox[slot]);
+
+        PacketBatch frameBatch;
+        uint32_t ack = match.sessions[slot].GetConfirmedFrame();
+        if (match.streams[slot].Queue(batcher, match.players[slot], frameBatch, ack)) {
+            batcher.Send(match.players[slot], frameBatch, CHANNEL_FRAMES);
+        }
+    }
+}
+
+// --- MATCHES ---
+
+int MatchServer::GetSlot(const Match& match, const ENetPeer* peer) {
+    if (match.players[0] == peer) return 0;
+    return match.players[1] == peer ? 1 : -1;
+}
+
+void MatchServer::StartMatch(ENetPeer* first, ENetPeer* second) {
+    std::unique_ptr<Match> match(new Match());
+    match->players[0] = first;
+    match->players[1] = second;
+    match->id = nextMatchId++;
+    first->data = match.get();
+    if (second) second->data = match.get();
+    else {
+        match->bot.reset(new AIPlayer(BOT_LOOKAHEAD, BOT_BEAM_WIDTH, 1));
+        match->bot->ticksPerMove = BOT_TICKS_PER_MOVE;
+    }
+    StartRound(*match);
+    matches.push_back(std::move(match));
+}
+
+void MatchServer::StartRound(Match& match) {
+    // Distinct seeds per match even when several start in the same second
+    unsigned int* seeds = match.seeds;
+    seeds[0] = (unsigned int)time(NULL) + 7919u * seedCounter++;
+    seeds[1] = useSameSeeds ? seeds[0] : seeds[0] + 9999;
+
+    // Each player sees itself as the client: own seed second, opponent's first
+    match.round++;
+    for (int slot = 0; slot < 2; slot++) {
+        match.games[slot].Reset(seeds[slot]);
+        match.sessions[slot].Start();
+        match.streams[slot].Reset(match.round);
+        Send(match.players[slot], WireProtocol::MakeSeed(match.round, seeds[1 - slot], seeds[slot]));
+
+        // Frames of the old round not broadcast yet are dropped
+        match.watchInputs[slot].clear();
+        match.watchedFrames[slot] = 0;
+    }
+
+    if (match.bot) {
+        match.bot->Reset();
+        match.botCountdown = BOT_COUNTDOWN;
+        match.botPaused = false;
+    }
+
+    // Spectators see board 0 as the host's
+    batcher.QueueBroadcast(match.spectators, match.watchBatch, WireProtocol::MakeSeed(match.round, seeds[0], seeds[1]));
+}
+
+void MatchServer::EndMatch(ENetPeer* peer) {
+    if (peer == waiting) waiting = nullptr;
+    Match* match = (Match*)peer->data;
+    if (!match) return;
+
+    // A spectator leaving only unsubscribes
+    int slot = GetSlot(*match, peer);
+    if (slot < 0) {
+        for (std::vector<ENetPeer*>* list : { &match->spectators, &match->joiningSpectators }) {
+            auto it = std::find(list->begin(), list->end(), peer);
+            if (it == list->end()) continue;
+            *it = list->back();
+            list->pop_back();
+        }
+        peer->data = nullptr;
+        return;
+    }
+
+    // Spectators see the match up to its last confirmed frame
+    StepMatch(*match);
+    FlushSpectators(*match);
+    ReleaseSpectators(*match);
+
+    // The opponent gets what was still queued for it, then the quit
+    ENetPeer* opponent = match->players[1 - slot];
+    if (opponent) {
+        Send(opponent, WireProtocol::Make(PACKET_QUIT));
+        batcher.Send(opponent, match->outbox[1 - slot]);
+        enet_peer_disconnect(opponent, 0);
+        opponent->data = nullptr;
+    }
+    batcher.Discard(match->outbox[slot]);
+    peer->data = nullptr;
+
+    auto it = std::find_if(matches.begin(), matches.end(),
+                           [match](const std::unique_ptr<Match>& m) { return m.get() == match; });
+    std::swap(*it, matches.back());
+    matches.pop_back();
+}
+
+// --- SPECTATORS ---
+
+void MatchServer::Watch(ENetPeer* peer, uint64_t matchId) {
+    if (peer == waiting) waiting = nullptr; // Would rather watch than play
+
+    Match* watched = nullptr;
+    for (const std::unique_ptr<Match>& match : matches) {
+        if (matchId ? match->id == matchId : (!watched || match->id < watched->id)) watched = match.get();
+    }
+    // No such match: the spectator is turned away
+    if (!watched) {
+        Send(peer, WireProtocol::Make(PACKET_QUIT));
+        enet_peer_disconnect(peer, 0);
+        return;
+    }
+
+    peer->data = watched;
+    watched->joiningSpectators.push_back(peer);
+}
+
+size_t MatchServer::GetSpectatorCount() const {
+    size_t total = 0;
+    for (const std::unique_ptr<Match>& match : matches) total += match->spectators.size() + match->joiningSpectators.size();
+    return total;
+}
+
+void MatchServer::FlushSpectators(Match& match) {
+    for (uint8_t board = 0; board < 2; board++) {
+        std::vector<FrameInput>& inputs = match.watchInputs[board];
+        uint32_t confirmed = match.sessions[board].GetConfirmedFrame();
+
+        // 1. Frames confirmed since the last tick (nothing is encoded without spectators)
+        size_t next = 0;
+        uint32_t watched = match.watchedFrames[board];
+        while (!match.spectators.empty() && watched < confirmed) {
+            NetMessage window = WireProtocol::Make(PACKET_WATCH_FRAMES);
+            window.board = board;
+            window.frame = watched;
+            window.endFrame = confirmed;
+            for (; next < inputs.size(); next++) {
+                // A full window stops right before the first input it cannot list
+                if (window.inputCount == MAX_WINDOW_INPUTS) {
+                    window.endFrame = inputs[next].frame;
+                    break;
+                }
+                window.inputs[window.inputCount++] = inputs[next];
+            }
+            batcher.QueueBroadcast(match.spectators, match.watchBatch, window);
+            watched = window.endFrame;
+        }
+        inputs.clear();
+        match.watchedFrames[board] = confirmed;
+    }
+
+    // One packet for every spectator, however many there are
+    batcher.Broadcast(match.spectators, match.watchBatch);
+
+    // 2. Spectators who just joined start from the seeds and both boards (at the frame the stream is at)
+    if (match.joiningSpectators.empty()) return;
+    uint8_t seed[WireProtocol::MAX_MESSAGE_SIZE];
+    size_t length = WireProtocol::Encode(WireProtocol::MakeSeed(match.round, match.seeds[0], match.seeds[1]), seed);
+    std::vector<uint8_t> start(seed, seed + length);
+    for (uint8_t board = 0; board < 2; board++) {
+        Snapshot state;
+        match.games[board].Save(state);
+        WireProtocol::AppendWatchState(board, match.sessions[board].GetFrame(), state, start);
+    }
+
+    PacketBatch none;
+    batcher.BroadcastLarge(match.joiningSpectators, none, start);
+    match.spectators.insert(match.spectators.end(), match.joiningSpectators.begin(), match.joiningSpectators.end());
+    match.joiningSpectators.clear();
+}
+
+void MatchServer::ReleaseSpectators(Match& match) {
+    // Nothing was sent to the joining ones yet: the quit is all they get
+    match.spectators.insert(match.spectators.end(), match.joiningSpectators.begin(), match.joiningSpectators.end());
+    match.joiningSpectators.clear();
+    batcher.QueueBroadcast(match.spectators, match.watchBatch, WireProtocol::Make(PACKET_QUIT));
+    batcher.Broadcast(match.spectators, match.watchBatch);
+
+    for (ENetPeer* spectator : match.spectators) {
+        enet_peer_disconnect(spectator, 0);
+        spectator->data = nullptr;
+    }
+    match.spectators.clear();
+}
+
+// --- TICKETS ---
+
+void MatchServer::AddTicket(const MatchTicket& ticket) {
+    tickets.push_back({ ticket, { nullptr, nullptr }, 0.0 });
+}
+
+void MatchServer::JoinTicket(ENetPeer* peer, uint64_t token) {
+    for (size_t i = 0; i < tickets.size(); i++) {
+        PendingTicket& pending = tickets[i];
+        int slot = pending.ticket.tokens[0] == token ? 0 : (pending.ticket.tokens[1] == token ? 1 : -1);
+        if (slot < 0 || token == 0) continue;
+
+        // A ticket without a second token is a match against the bot
+        pending.players[slot] = peer;
+        if (pending.players[0] && (pending.players[1] || pending.ticket.tokens[1] == 0)) {
+            StartMatch(pending.players[0], pending.players[1]);
+            tickets[i] = tickets.back();
+            tickets.pop_back();
+        }
+        return;
+    }
+
+    // Unknown or expired token: the player goes back to the lobby
+    Send(peer, WireProtocol::Make(PACKET_QUIT));
+    enet_peer_disconnect(peer, 0);
+}
+
+void MatchServer::UpdateTickets(double elapsedSeconds, const ENetPeer* gone) {
+    for (size_t i = 0; i < tickets.size();) {
+        PendingTicket& pending = tickets[i];
+        for (ENetPeer*& player : pending.players) {
+            if (player == gone) player = nullptr;
+        }
+
+        pending.age += elapsedSeconds;
+        if (pending.age < TICKET_TIMEOUT) { i++; continue; }
+
+        // The opponent never showed up
+        for (ENetPeer* player : pending.players) {
+            if (!player) continue;
+            Send(player, WireProtocol::Make(PACKET_QUIT));
+            enet_peer_disconnect(player, 0);
+        }
+        tickets[i] = tickets.back();
+        tickets.pop_back();
+    }
+}
+
+// --- MAIN UPDATE LOOP ---
+
+void MatchServer::Update(double elapsedSeconds, uint32_t waitMs) {
+    if (!host) return;
+    ENetEvent event;
+
+    // Only the first poll may block; the rest drain what already arrived
+    while (enet_host_service(host, &event, waitMs) > 0) {
+        waitMs = 0;
+
+        // 1. CONNECTION: pair with the waiting player, or wait for the next one
+        if (event.type == ENET_EVENT_TYPE_CONNECT) {
+            event.peer->data = nullptr;
+            if (!pairOnConnect || event.data == CONNECT_SPECTATOR) continue; // Waits for its PACKET_JOIN / PACKET_WATCH
+            if (waiting) {
+                StartMatch(waiting, event.peer);
+                waiting = nullptr;
+            }
+            else {
+                waiting = event.peer;
+                waitingTime = 0;
+            }
+        }
+
+        // 2. PACKET RECEIVED
+        else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+            HandlePacket(event.peer, event.packet->data, event.packet->dataLength);
+            enet_packet_destroy(event.packet);
+        }
+
+        // 3. DISCONNECTION
+        else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
+            EndMatch(event.peer);
+            UpdateTickets(0, event.peer);
+        }
+    }
+
+    UpdateTickets(elapsedSeconds, nullptr);
+
+    // Nobody came: the waiting player gets the bot
+    if (waiting) {
+        waitingTime += elapsedSeconds;
+        if (botWaitSeconds >= 0 && waitingTime >= botWaitSeconds) {
+            StartMatch(waiting, nullptr);
+            waiting = nullptr;
+        }
+    }
+
+    for (const std::unique_ptr<Match>& match : matches) {
+        if (match->bot) StepBot(*match, elapsedSeconds);
+        StepMatch(*match);
+    }
+
+    // One packet per player and network tick, one shared by the spectators of each match
+    if (batcher.IsTickDue(elapsedSeconds)) {
+        for (const std::unique_ptr<Match>& match : matches) {
+            FlushMatch(*match);
+            FlushSpectators(*match);
+        }
+    }
+}
+
+void MatchServer::HandlePacket(ENetPeer* peer, const uint8_t* data, size_t size) {
+    // A malformed message (or another protocol version) drops the rest of the packet
+    NetMessage message;
+    size_t pos = 0;
+    while (WireProtocol::DecodeNext(data, size, pos, message)) HandleMessage(peer, message);
+}
+
+void MatchServer::HandleMessage(ENetPeer* peer, const NetMessage& message) {
+    Match* match = (Match*)peer->data;
+    if (!match) {
+        if (message.type == PACKET_JOIN) JoinTicket(peer, message.token);
+        else if (message.type == PACKET_WATCH) Watch(peer, message.token);
+        return;
+    }
+
+    // Spectators only listen
+    int slot = GetSlot(*match, peer);
+    if (slot < 0) return;
+    ENetPeer* opponent = match->players[1 - slot];
+
+    switch (message.type) {
+        // Frames are simulated once confirmed (StepMatch), with the same inputs the opponent applies.
+        // New inputs join the opponent's stream and the spectators'; windows of an earlier round are stale.
+        case PACKET_INPUT: {
+            if (message.round != match->round) break;
+            RollbackSession& session = match->sessions[slot];
+            InputChannel& relay = match->streams[1 - slot];
+            for (int i = 0; i < message.inputCount; i++) {
+                const FrameInput& input = message.inputs[i];
+                if (!session.AddInput(input.frame, input.input)) continue;
+                if (opponent) relay.AddInput(input.frame, input.input);
+                match->watchInputs[slot].push_back(input);
+            }
+            session.Confirm(message.endFrame);
+            if (opponent) relay.SetFrameCount(session.GetConfirmedFrame());
+            match->streams[slot].OnWindow(message, session.GetConfirmedFrame());
+            break;
+        }
+
+        // Checksums are verified here as well as by the opponent; either may ask for a resync.
+        // Once the player's board left the server's, the opponent follows the server's and stops checking.
+        case PACKET_CHECKSUM:
+            if (message.round != match->round) break;
+            match->sessions[slot].AddChecksum(message.frame, message.checksum);
+            if (opponent && !match->sessions[slot].IsDesynced()) match->streams[1 - slot].AddChecksum(message.frame, message.checksum);
+            break;
+
+        // The server's boards are the reference: a player's copy that diverged gets the server's,
+        // and a player's own board is never taken over
+        case PACKET_RESYNC_REQ:
+            SendBoard(*match, 1 - slot, slot);
+            break;
+        case PACKET_STATE:
+            break;
+
+        // Plain relays: the opponent answers them
+        case PACKET_RESTART_REQ:
+        case PACKET_PAUSE_REQ:
+        case PACKET_RESUME_REQ:
+        case PACKET_NEW_GAME:
+            if (opponent) Send(opponent, message);
+            else AnswerForBot(*match, message);
+            break;
+
+        // Responses are relayed, and an accepted restart starts a new round
+        // (pausing needs nothing here: the players' frames simply stop)
+        case PACKET_RESTART_RES:
+        case PACKET_PAUSE_RES:
+        case PACKET_RESUME_RES: {
+            if (!opponent) break; // The bot asks nothing
+            Send(opponent, message);
+            if (message.accepted && message.type == PACKET_RESTART_RES) StartRound(*match);
+            break;
+        }
+
+        case PACKET_QUIT:
+            EndMatch(peer);
+            break;
+
+        // Seeds belong to the server
+        default: break;
+    }
+}
+
+void MatchServer::SendBoard(Match& match, int board, int to) {
+    ENetPeer* player = match.players[to];
+    if (!player) return;
+    Snapshot state;
+    match.games[board].Save(state);
+    std::vector<uint8_t> message;
+    WireProtocol::EncodeState(match.sessions[board].GetFrame(), state, message);
+    batcher.SendLarge(player, match.outbox[to], message);
+}
+
+void MatchServer::StepMatch(Match& match) {
+    for (int slot = 0; slot < 2; slot++) {
+        uint32_t before = match.sessions[slot].GetFrame();
+        bool desync = match.sessions[slot].Advance(match.games[slot], 0);
+        framesSimulated += match.sessions[slot].GetFrame() - before;
+
+        // The player's board went its own way: the opponent keeps following the server's
+        if (desync) SendBoard(match, slot, 1 - slot);
+    }
+}
+
+// --- SERVER BOT ---
+
+void MatchServer::StepBot(Match& match, double elapsedSeconds) {
+    Simulation& game = match.games[BOT_SLOT];
+    if (match.botPaused || match.botCountdown > 0) {
+        if (!match.botPaused) match.botCountdown -= elapsedSeconds;
+        game.clock.Reset();
+        return;
+    }
+
+    // Frames run like NetworkManager::StepLocal: checksum before the frame, then the frame's input.
+    // They are final as soon as played, so the session never predicts.
+    RollbackSession& session = match.sessions[BOT_SLOT];
+    InputChannel& stream = match.streams[1 - BOT_SLOT];
+    int ticks = game.clock.Advance(elapsedSeconds);
+    for (int i = 0; i < ticks; i++) {
+        uint32_t frame = session.GetFrame();
+        if (frame % RollbackSession::CHECKSUM_INTERVAL == 0) stream.AddChecksum(frame, game.GetChecksum());
+
+        InputState input = match.bot->GetInput(game);
+        input.currentScore = 0;
+        if (input.left || input.right || input.down || input.rotate || input.hardDrop) {
+            session.AddInput(frame, input);
+            stream.AddInput(frame, input);
+            match.watchInputs[BOT_SLOT].push_back({ frame, input });
+        }
+        session.Confirm(frame + 1);
+        stream.SetFrameCount(frame + 1);
+        session.Advance(game, 0);
+        framesSimulated++;
+    }
+}
+
+void MatchServer::AnswerForBot(Match& match, const NetMessage& message) {
+    ENetPeer* player = match.players[1 - BOT_SLOT];
+    switch (message.type) {
+        // The bot agrees to everything and runs the same countdown as the player
+        case PACKET_RESTART_REQ:
+            Send(player, WireProtocol::MakeResponse(PACKET_RESTART_RES, true));
+            StartRound(match);
+            break;
+        case PACKET_PAUSE_REQ:
+            Send(player, WireProtocol::MakeResponse(PACKET_PAUSE_RES, true));
+            match.botPaused = true;
+            break;
+        case PACKET_RESUME_REQ:
+            Send(player, WireProtocol::MakeResponse(PACKET_RESUME_RES, true));
+            match.botPaused = false;
+            match.botCountdown = BOT_COUNTDOWN;
+            break;
+
+        // PACKET_NEW_GAME: the bot has no screen to leave
+        default: break;
+    }
+}
@@ -0,0 +1,178 @@
+/**
+ * @file network_shim.cpp
+ * @brief Implementation of the NetworkShim class.
+ */
+
+// 1. Windows-specific protection definitions
+#if defined(_WIN32)
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+#include <enet/enet.h>
+#include "../include/network_shim.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// Largest datagram relayed (ENet's maximum MTU)
+static const size_t MAX_DATAGRAM = 4096;
+
+// --- CONSTRUCTOR / DESTRUCTOR ---
+
+NetworkShim::NetworkShim()
+    : listenSocket(0), serverSocket(0), clientHost(0), serverHost(0), clientPort(0), serverPort(0),
+      hasClient(false), running(false), arrivals(0) {
+    if (enet_initialize() != 0) {
+        std::cerr << "[Shim] Error initializing ENet!\n";
+    }
+}
+
+NetworkShim::~NetworkShim() {
+    Stop();
+    enet_deinitialize();
+}
+
+// --- CONNECTION MANAGEMENT ---
+
+bool NetworkShim::Start(int listenPort, const char* serverName, int port, uint32_t seed) {
+    Stop();
+
+    // Loopback only: the whole path stays on this machine
+    ENetAddress local;
+    enet_address_set_host_ip(&local, "127.0.0.1");
+    local.port = (enet_uint16)listenPort;
+
+    ENetAddress target;
+    if (enet_address_set_host(&target, serverName) != 0) return false;
+    target.port = (enet_uint16)port;
+
+    ENetSocket listening = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+    ENetSocket relaying = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+    ENetAddress ephemeral = local;
+    ephemeral.port = 0;
+    bool ok = listening != ENET_SOCKET_NULL && relaying != ENET_SOCKET_NULL &&
+              enet_socket_bind(listening, &local) == 0 && enet_socket_bind(relaying, &ephemeral) == 0 &&
+              enet_socket_set_option(listening, ENET_SOCKOPT_NONBLOCK, 1) == 0 &&
+              enet_socket_set_option(relaying, ENET_SOCKOPT_NONBLOCK, 1) == 0;
+    if (!ok) {
+        if (listening != ENET_SOCKET_NULL) enet_socket_destroy(listening);
+        if (relaying != ENET_SOCKET_NULL) enet_socket_destroy(relaying);
+        return false;
+    }
+
+    listenSocket = (intptr_t)listening;
+    serverSocket = (intptr_t)relaying;
+    serverHost = target.host;
+    serverPort = target.port;
+    hasClient = false;
+    running = true;
+
+    // Profiles are kept, everything else starts over
+    for (Link& link : links) {
+        link.stats = LinkStats();
+        link.pending = decltype(link.pending)();
+        link.lastDue = 0;
+    }
+    arrivals = 0;
+    rng.seed(seed);
+    return true;
+}
+
+void NetworkShim::Stop() {
+    if (!running) return;
+    enet_socket_destroy((ENetSocket)listenSocket);
+    enet_socket_destroy((ENetSocket)serverSocket);
+    for (Link& link : links) link.pending = decltype(link.pending)();
+    running = false;
+}
+
+// --- RELAY ---
+
+uint64_t NetworkShim::NowMicros() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void NetworkShim::Update() {
+    if (!running) return;
+    uint64_t now = NowMicros();
+
+    uint8_t buffer[MAX_DATAGRAM];
+    ENetBuffer view;
+    view.data = buffer;
+    view.dataLength = sizeof(buffer);
+    ENetAddress from;
+    int length;
+
+    // 1. Client to server: the first sender is the client, anyone else is ignored
+    while ((length = enet_socket_receive((ENetSocket)listenSocket, &from, &view, 1)) > 0) {
+        if (!hasClient) {
+            clientHost = from.host;
+            clientPort = from.port;
+            hasClient = true;
+        }
+        if (from.host != clientHost || from.port != clientPort) continue;
+        Schedule(links[LINK_TO_SERVER], buffer, (size_t)length, now);
+    }
+
+    // 2. Server to client
+    while ((length = enet_socket_receive((ENetSocket)serverSocket, &from, &view, 1)) > 0) {
+        if (hasClient) Schedule(links[LINK_TO_CLIENT], buffer, (size_t)length, now);
+    }
+
+    // 3. Whatever is due
+    Deliver(links[LINK_TO_SERVER], serverSocket, serverHost, serverPort, now);
+    if (hasClient) Deliver(links[LINK_TO_CLIENT], listenSocket, clientHost, clientPort, now);
+}
+
+void NetworkShim::Schedule(Link& link, const uint8_t* data, size_t size, uint64_t now) {
+    const LinkProfile& profile = link.profile;
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    link.stats.packets++;
+    link.stats.bytes += size;
+
+    if (chance(rng) < profile.loss) {
+        link.stats.dropped++;
+        return;
+    }
+
+    int copies = 1;
+    if (chance(rng) < profile.duplicate) {
+        copies = 2;
+        link.stats.duplicated++;
+    }
+
+    for (int i = 0; i < copies; i++) {
+        uint64_t due = now + (uint64_t)((profile.delayMs + profile.jitterMs * chance(rng)) * 1000.0);
+
+        // A held-back datagram is overtaken by the next ones; the others stay in order
+        if (chance(rng) < profile.reorder) {
+            due += (uint64_t)(profile.reorderMs * 1000.0);
+            link.stats.reordered++;
+        }
+        else {
+            due = std::max(due, link.lastDue);
+            link.lastDue = due;
+        }
+        link.pending.push({ due, arrivals++, std::vector<uint8_t>(data, data + size) });
+    }
+}
+
+void NetworkShim::Deliver(Link& link, intptr_t socket, uint32_t host, uint16_t port, uint64_t now) {
+    ENetAddress to;
+    to.host = host;
+    to.port = port;
+
+    while (!link.pending.empty() && link.pending.top().due <= now) {
+        const Datagram& datagram = link.pending.top();
+        ENetBuffer view;
+        view.data = (void*)datagram.data.data();
+        view.dataLength = datagram.data.size();
+        enet_socket_send((ENetSocket)socket, &to, &view, 1);
+        link.pending.pop();
+    }
+}
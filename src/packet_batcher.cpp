@@ -0,0 +1,140 @@
+/**
+ * @file packet_batcher.cpp
+ * @brief Implementation of the PacketBatcher class.
+ */
+
+// 1. Windows-specific protection definitions
+#if defined(_WIN32)
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+#include <enet/enet.h>
+#include "../include/packet_batcher.hpp"
+
+// --- CONSTRUCTOR ---
+
+PacketBatcher::PacketBatcher() : tickTimer(0), packetsSent(0), packetsBuilt(0), messagesSent(0), bytesSent(0) {}
+
+// --- BUFFER POOL ---
+
+uint8_t* PacketBatcher::Acquire() {
+    if (freeBuffers.empty()) {
+        storage.emplace_back(new uint8_t[BUFFER_SIZE]);
+        return storage.back().get();
+    }
+    uint8_t* buffer = freeBuffers.back();
+    freeBuffers.pop_back();
+    return buffer;
+}
+
+void PacketBatcher::Release(ENetPacket* packet) {
+    PacketBatcher* owner = (PacketBatcher*)packet->userData;
+    owner->freeBuffers.push_back(packet->data);
+}
+
+// --- BATCHING ---
+
+void PacketBatcher::Queue(ENetPeer* peer, PacketBatch& batch, const NetMessage& message, NetChannel channel) {
+    if (batch.length + WireProtocol::MAX_MESSAGE_SIZE > BUFFER_SIZE) Send(peer, batch, channel);
+    if (!batch.buffer) batch.buffer = Acquire();
+    batch.length += WireProtocol::Encode(message, batch.buffer + batch.length);
+    batch.messages++;
+}
+
+ENetPacket* PacketBatcher::Build(PacketBatch& batch, NetChannel channel) {
+    if (batch.messages == 0) return nullptr;
+
+    // The packet points at the pool buffer; ENet hands it back through Release
+    // (once acknowledged, or right after sending when unreliable)
+    enet_uint32 flags = ENET_PACKET_FLAG_NO_ALLOCATE | (channel == CHANNEL_CONTROL ? ENET_PACKET_FLAG_RELIABLE : 0);
+    ENetPacket* packet = enet_packet_create(batch.buffer, batch.length, flags);
+    if (!packet) { Discard(batch); return nullptr; }
+    packet->userData = this;
+    packet->freeCallback = Release;
+
+    batch.buffer = nullptr;
+    batch.length = 0;
+    batch.messages = 0;
+    return packet;
+}
+
+void PacketBatcher::Deliver(ENetPacket* packet, ENetPeer* const* peers, size_t count, NetChannel channel, uint32_t messages) {
+    packetsBuilt++;
+    for (size_t i = 0; i < count; i++) {
+        if (enet_peer_send(peers[i], (enet_uint8)channel, packet) < 0) continue;
+        packetsSent++;
+        messagesSent += messages;
+        bytesSent += packet->dataLength;
+    }
+
+    // Every peer that took the packet holds a reference; ENet frees it after the last one
+    if (packet->referenceCount == 0) enet_packet_destroy(packet);
+}
+
+void PacketBatcher::Send(ENetPeer* peer, PacketBatch& batch, NetChannel channel) {
+    uint32_t messages = batch.messages;
+    ENetPacket* packet = Build(batch, channel);
+    if (packet) Deliver(packet, &peer, 1, channel, messages);
+}
+
+void PacketBatcher::SendNow(ENetPeer* peer, const NetMessage& message) {
+    PacketBatch batch;
+    Queue(peer, batch, message);
+    Send(peer, batch);
+}
+
+void PacketBatcher::SendLarge(ENetPeer* peer, PacketBatch& batch, const std::vector<uint8_t>& message) {
+    Send(peer, batch);
+
+    // Rare (resyncs only): an ordinary ENet-owned copy
+    ENetPacket* packet = enet_packet_create(message.data(), message.size(), ENET_PACKET_FLAG_RELIABLE);
+    if (packet) Deliver(packet, &peer, 1, CHANNEL_CONTROL, 1);
+}
+
+// --- BROADCAST ---
+
+void PacketBatcher::QueueBroadcast(const std::vector<ENetPeer*>& peers, PacketBatch& batch, const NetMessage& message) {
+    if (batch.length + WireProtocol::MAX_MESSAGE_SIZE > BUFFER_SIZE) Broadcast(peers, batch);
+    if (!batch.buffer) batch.buffer = Acquire();
+    batch.length += WireProtocol::Encode(message, batch.buffer + batch.length);
+    batch.messages++;
+}
+
+void PacketBatcher::Broadcast(const std::vector<ENetPeer*>& peers, PacketBatch& batch) {
+    if (peers.empty()) { Discard(batch); return; }
+    uint32_t messages = batch.messages;
+    ENetPacket* packet = Build(batch, CHANNEL_CONTROL);
+    if (packet) Deliver(packet, peers.data(), peers.size(), CHANNEL_CONTROL, messages);
+}
+
+void PacketBatcher::BroadcastLarge(const std::vector<ENetPeer*>& peers, PacketBatch& batch, const std::vector<uint8_t>& message) {
+    Broadcast(peers, batch);
+    if (peers.empty()) return;
+
+    ENetPacket* packet = enet_packet_create(message.data(), message.size(), ENET_PACKET_FLAG_RELIABLE);
+    if (packet) Deliver(packet, peers.data(), peers.size(), CHANNEL_CONTROL, 1);
+}
+
+void PacketBatcher::Discard(PacketBatch& batch) {
+    if (batch.buffer) freeBuffers.push_back(batch.buffer);
+    batch.buffer = nullptr;
+    batch.length = 0;
+    batch.messages = 0;
+}
+
+bool PacketBatcher::IsTickDue(double elapsedSeconds) {
+    double interval = 1.0 / (sendRate > 0 ? sendRate : 1);
+    tickTimer += elapsedSeconds;
+
+    // Same epsilon as SimClock: frames that add up to exactly one interval are due
+    if (tickTimer + 1e-9 < interval) return false;
+
+    // Keep the phase, but never owe a burst of ticks after a stall
+    tickTimer -= interval;
+    if (tickTimer >= interval) tickTimer = 0;
+    return true;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file piece_bag.cpp
+ * @brief Implementation of the PieceBag class.
+ */
+
+#include "../include/piece_bag.hpp"
+#include "../include/zobrist.hpp"
+
+static_assert(sizeof(PieceBag) <= 32, "PieceBag should stay compact");
+
+PieceBag::PieceBag() {
+    Reset(0);
+}
+
+void PieceBag::Reset(uint32_t seed) {
+    // Standard PCG32 seeding sequence
+    rngState = 0;
+    NextRandom();
+    rngState += seed;
+    NextRandom();
+
+    bagMask = 0;
+    queueHead = 0;
+    queueCount = 0;
+}
+
+uint32_t PieceBag::NextRandom() {
+    uint64_t old = rngState;
+    rngState = old * 6364136223846793005ull + 1442695040888963407ull;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+}
+
+int PieceBag::DrawFromBag() {
+    // Refill the bag with all seven pieces once it is empty
+    if (bagMask == 0) bagMask = 0x7F;
+
+    // Pick the k-th remaining piece uniformly (multiply-shift bounded random)
+    uint32_t remaining = bagMask;
+    uint32_t k = (uint32_t)(((uint64_t)NextRandom() * __builtin_popcount(remaining)) >> 32);
+    while (k--) remaining &= remaining - 1;
+
+    int bit = __builtin_ctz(remaining);
+    bagMask &= (uint8_t)~(1u << bit);
+    return bit + 1; // Bits 0-6 map to Block IDs 1-7
+}
+
+int PieceBag::Next() {
+    if (queueCount == 0) return DrawFromBag();
+
+    int piece = queue[queueHead];
+    queueHead = (queueHead + 1) & 15;
+    queueCount--;
+    return piece;
+}
+
+int PieceBag::Peek(int index) {
+    // Draw ahead lazily; each piece is generated exactly once, in order
+    while (queueCount <= index) {
+        queue[(queueHead + queueCount) & 15] = (uint8_t)DrawFromBag();
+        queueCount++;
+    }
+    return queue[(queueHead + index) & 15];
+}
+uint64_t PieceBag::GetChecksum() const {
+    // Canonical form: every bag with the preview queue filled to the same depth
+    // has drawn the same random numbers, whatever Peek already did to this one
+    PieceBag canonical = *this;
+    canonical.Peek(MAX_PREVIEW - 1);
+
+    uint64_t pieces = canonical.bagMask;
+    for (int i = 0; i < MAX_PREVIEW; i++) {
+        pieces |= (uint64_t)canonical.queue[(canonical.queueHead + i) & 15] << (7 + 3 * i);
+    }
+
+    return Zobrist::Mix(canonical.rngState ^ Zobrist::Mix(pieces));
+}
@@ -0,0 +1,208 @@
+/**
+ * @file placement_enumerator.cpp
+ * @brief Implementation of the PlacementEnumerator class.
+ */
+
+#include "../include/placement_enumerator.hpp"
+#include <cstring>
+
+// --- LOCAL HELPER FUNCTIONS ---
+
+// For every (piece, rotation): the lowest rotation of the same piece that covers the same
+// cells, and the offset that maps a placement onto it. Used to report symmetric locks once.
+struct CanonicalRotations {
+    int8_t rotation[8][Block::NUM_ROTATIONS];
+    int8_t rowDelta[8][Block::NUM_ROTATIONS];
+    int8_t columnDelta[8][Block::NUM_ROTATIONS];
+};
+
+static CanonicalRotations BuildCanonicalRotations() {
+    CanonicalRotations table = {};
+    int top[Block::NUM_ROTATIONS], left[Block::NUM_ROTATIONS];
+    uint8_t normalized[Block::NUM_ROTATIONS][4];
+
+    for (int id = 1; id < 8; id++) {
+        for (int r = 0; r < Block::NUM_ROTATIONS; r++) {
+            // Shape moved to the top-left corner of its 4x4 box
+            const std::array<uint8_t, 4>& masks = Block::GetRowMasks(id, r);
+            top[r] = 0;
+            while (masks[top[r]] == 0) top[r]++;
+            left[r] = __builtin_ctz(masks[0] | masks[1] | masks[2] | masks[3]);
+            for (int row = 0; row < 4; row++) {
+                normalized[r][row] = (row + top[r] < 4) ? (uint8_t)(masks[row + top[r]] >> left[r]) : 0;
+            }
+
+            table.rotation[id][r] = (int8_t)r;
+            for (int other = 0; other < r; other++) {
+                if (memcmp(normalized[other], normalized[r], 4) == 0) {
+                    table.rotation[id][r] = (int8_t)other;
+                    table.rowDelta[id][r] = (int8_t)(top[r] - top[other]);
+                    table.columnDelta[id][r] = (int8_t)(left[r] - left[other]);
+                    break;
+                }
+            }
+        }
+    }
+    return table;
+}
+
+static const CanonicalRotations& GetCanonicalRotations() {
+    static const CanonicalRotations table = BuildCanonicalRotations();
+    return table;
+}
+
+// --- FIT MASKS ---
+
+PlacementEnumerator::PlacementEnumerator()
+    : rows(nullptr), pieceId(0), startRotation(0), startRow(0), startColumn(0), fitReady(0), count(0) {}
+
+uint32_t PlacementEnumerator::GetFitRows(int rotation, int column) {
+    if (column < COLUMN_MIN || column >= COLUMN_MIN + COLUMN_SPAN) return 0;
+    int c = column - COLUMN_MIN;
+
+    uint64_t readyBit = 1ull << (rotation * COLUMN_SPAN + c);
+    if (fitReady & readyBit) return fitRows[rotation][c];
+    fitReady |= readyBit;
+
+    // Start from every row offset, then remove the ones where a piece row is
+    // outside the grid or overlaps the stack (same rules as Grid::PieceFitsRows)
+    uint32_t fit = (1u << ROW_SPAN) - 1;
+    int shift = Grid::ColumnBit(column);
+    const std::array<uint8_t, 4>& masks = Block::GetRowMasks(pieceId, rotation);
+    for (int k = 0; k < 4 && fit; k++) {
+        if (masks[k] == 0) continue;
+        uint32_t shifted = (uint32_t)masks[k] << shift;
+        if (shifted > Grid::FULL_ROW) { fit = 0; break; }
+
+        // Piece row k lands on grid row (offset + k), which must lie in [0, NUM_ROWS)
+        uint32_t inside = 0;
+        for (int gridRow = 0; gridRow < Grid::NUM_ROWS; gridRow++) {
+            if ((rows[gridRow] & shifted) == 0) inside |= 1u << (gridRow - k - ROW_MIN);
+        }
+        fit &= inside;
+    }
+    fitRows[rotation][c] = fit;
+    return fit;
+}
+
+bool PlacementEnumerator::Fits(int rotation, int row, int column) {
+    if (row < ROW_MIN || row >= Grid::NUM_ROWS) return false;
+    return (GetFitRows(rotation, column) >> (row - ROW_MIN)) & 1;
+}
+
+// --- ENUMERATION ---
+
+int PlacementEnumerator::Enumerate(const Grid& grid, const Block& block) {
+    return Enumerate(grid.GetRows(), block.id, block.GetRotation(), block.GetRow(), block.GetColumn());
+}
+
+int PlacementEnumerator::Enumerate(const uint16_t* rows, int id, int rotation, int row, int column) {
+    count = 0;
+    this->rows = rows;
+    pieceId = id;
+    startRotation = rotation;
+    startRow = row;
+    startColumn = column;
+    fitReady = 0;
+    if (!Fits(rotation, row, column)) return 0;
+
+    // Reached rows per (rotation, column), and a worklist with one bit per (rotation, column)
+    uint32_t reached[Block::NUM_ROTATIONS][COLUMN_SPAN] = {};
+    reached[rotation][column - COLUMN_MIN] = 1u << (row - ROW_MIN);
+    uint64_t pending = 1ull << (rotation * COLUMN_SPAN + (column - COLUMN_MIN));
+
+    while (pending) {
+        int item = __builtin_ctzll(pending);
+        pending &= pending - 1;
+        int r = item / COLUMN_SPAN;
+        int x = item % COLUMN_SPAN + COLUMN_MIN;
+
+        // Moving down: each reached row extends to the end of its run of fitting rows.
+        // Adding the reached bits to the fit mask carries through exactly those runs.
+        uint32_t fit = GetFitRows(r, x);
+        uint32_t current = reached[r][x - COLUMN_MIN];
+        current |= ((fit + current) ^ fit) & fit;
+        reached[r][x - COLUMN_MIN] = current;
+
+        // Left, right and rotate keep the row, so they move whole masks
+        const int neighbors[3][2] = {{r, x - 1}, {r, x + 1}, {(r + 1) % Block::NUM_ROTATIONS, x}};
+        for (const auto& n : neighbors) {
+            uint32_t add = current & GetFitRows(n[0], n[1]);
+            if (add == 0) continue;
+            uint32_t& target = reached[n[0]][n[1] - COLUMN_MIN];
+            if ((add & ~target) == 0) continue;
+            target |= add;
+            pending |= 1ull << (n[0] * COLUMN_SPAN + (n[1] - COLUMN_MIN));
+        }
+    }
+
+    // Locks: reached rows where the row below does not fit. Symmetric duplicates are
+    // mapped to their canonical rotation and reported once.
+    const CanonicalRotations& canonical = GetCanonicalRotations();
+    uint32_t reported[Block::NUM_ROTATIONS][COLUMN_SPAN + 4] = {};
+    for (int r = 0; r < Block::NUM_ROTATIONS; r++) {
+        for (int c = 0; c < COLUMN_SPAN; c++) {
+            uint32_t locks = reached[r][c] & ~(GetFitRows(r, c + COLUMN_MIN) >> 1);
+            while (locks) {
+                int bit = __builtin_ctz(locks);
+                locks &= locks - 1;
+                int y = bit + ROW_MIN;
+                int x = c + COLUMN_MIN;
+
+                int cr = canonical.rotation[id][r];
+                int key = c + canonical.columnDelta[id][r];
+                uint32_t keyBit = 1u << (bit + canonical.rowDelta[id][r]);
+                if (reported[cr][key] & keyBit) continue;
+                reported[cr][key] |= keyBit;
+
+                placements[count++] = {(int8_t)r, (int8_t)y, (int8_t)x};
+            }
+        }
+    }
+    return count;
+}
+
+// --- PATHS ---
+
+int PlacementEnumerator::GetPath(int index, PlacementMove* out, int maxMoves) {
+    const Placement& goal = placements[index];
+    int target = StateIndex(goal.rotation, goal.row, goal.column);
+    int start = StateIndex(startRotation, startRow, startColumn);
+
+    // Breadth-first search from the start placement, so the first path found is a shortest one
+    memset(visited, 0, sizeof(visited));
+    visited[start >> 6] |= 1ull << (start & 63);
+    queue[0] = (uint16_t)start;
+    int head = 0, tail = 1;
+
+    while (head < tail) {
+        int state = queue[head++];
+        if (state == target) break;
+
+        int r = state / (ROW_STRIDE * COLUMN_SPAN);
+        int y = (state / COLUMN_SPAN) % ROW_STRIDE + ROW_MIN;
+        int x = state % COLUMN_SPAN + COLUMN_MIN;
+
+        // Same order as Simulation::HandleInput: left, right, rotate, then down
+        const int moves[4][3] = {{r, y, x - 1}, {r, y, x + 1}, {(r + 1) % Block::NUM_ROTATIONS, y, x}, {r, y + 1, x}};
+        for (int m = 0; m < 4; m++) {
+            if (!Fits(moves[m][0], moves[m][1], moves[m][2])) continue;
+            int next = StateIndex(moves[m][0], moves[m][1], moves[m][2]);
+            uint64_t bit = 1ull << (next & 63);
+            if (visited[next >> 6] & bit) continue;
+            visited[next >> 6] |= bit;
+            parent[next] = (uint16_t)state;
+            parentMove[next] = (uint8_t)m;
+            queue[tail++] = (uint16_t)next;
+        }
+    }
+
+    // Count the moves, then fill the path from its end
+    int length = 0;
+    for (int state = target; state != start; state = parent[state]) length++;
+    int i = length;
+    for (int state = target; state != start; state = parent[state]) {
+        if (--i < maxMoves) out[i] = (PlacementMove)parentMove[state];
+    }
+    return length;
+}
@@ -1,7 +0,0 @@
-#include "../include/position.hpp"
-
-
-Position::Position(int row, int column){
-    this -> row = row;
-    this -> column = column;
-}
\ No newline at end of file
@@ -0,0 +1,347 @@
+/**
+ * @file replay.cpp
+ * @brief Implementation of the ReplayWriter and ReplayReader classes.
+ *
+ * Keyframe body (after its zero tag):
+ *   varint tick, varint score, varint level, varint lines, u8 gameOver, varint gravityCounter,
+ *   current block (u8 id, u8 rotation, zigzag row, zigzag column), u8 next block id,
+ *   bag (u64 rngState, u8 bagMask, u8 queueCount, queueCount piece IDs from the head),
+ *   NUM_ROWS varint packed color rows (3 bits per cell, see Grid).
+ */
+
+#include "../include/replay.hpp"
+
+static const uint8_t MAGIC[4] = {'T', 'R', 'P', 'L'};
+
+// Input bits plus the gravity flag
+static const uint8_t TICK_BITS_MASK = 0x7F;
+
+// --- LOCAL HELPER FUNCTIONS ---
+
+static void WriteVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static bool ReadVarint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < size; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false; // Truncated or over-long
+}
+
+static void WriteLittleEndian(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+static uint64_t ReadLittleEndian(const uint8_t* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint64_t)data[i] << (8 * i);
+    return value;
+}
+
+// Signed values (block rows start above the grid) as small unsigned varints
+static uint64_t ZigZag(int value) { return ((uint64_t)(uint32_t)value << 1) ^ (uint64_t)(int64_t)(value >> 31); }
+static int UnZigZag(uint64_t value) { return (int)(value >> 1) ^ -(int)(value & 1); }
+
+// Rebuilds a block from its stored placement
+static Block MakeBlock(int id, int rotation, int row, int column) {
+    Block block = (id != 0) ? CreateBlock(id) : Block();
+    for (int i = 0; i < rotation; i++) block.Rotate();
+    block.Move(row - block.GetRow(), column - block.GetColumn());
+    return block;
+}
+
+// --- WRITER ---
+
+ReplayWriter::ReplayWriter(int keyframeInterval)
+    : flushed(0), idleTicks(0), keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 600) {}
+
+uint8_t ReplayWriter::EncodeInput(InputState input) {
+    return (input.left ? REPLAY_LEFT : 0) | (input.right ? REPLAY_RIGHT : 0) |
+           (input.down ? REPLAY_DOWN : 0) | (input.rotate ? REPLAY_ROTATE : 0) |
+           (input.hardDrop ? REPLAY_HARD_DROP : 0) | (input.reset ? REPLAY_RESET : 0);
+}
+
+void ReplayWriter::Begin(Simulation& game) {
+    data.clear();
+    flushed = 0;
+    idleTicks = 0;
+
+    for (uint8_t byte : MAGIC) data.push_back(byte);
+    WriteLittleEndian(data, VERSION, 2);
+    WriteLittleEndian(data, (uint64_t)keyframeInterval, 2);
+    WriteLittleEndian(data, game.GetSeed(), 4);
+    WriteLittleEndian(data, 0, 4);
+
+    WriteKeyframe(game);
+    game.SetRecorder(this);
+}
+
+void ReplayWriter::RecordTick(const Simulation& game, InputState input, bool gravity) {
+    uint8_t bits = EncodeInput(input) | (gravity ? REPLAY_GRAVITY : 0);
+    if (bits == 0) {
+        idleTicks++;
+    }
+    else {
+        WriteVarint(data, ((uint64_t)idleTicks << 7) | bits);
+        idleTicks = 0;
+    }
+
+    if (game.GetTick() % keyframeInterval == 0) {
+        WriteIdle();
+        WriteKeyframe(game);
+    }
+}
+
+void ReplayWriter::Finish() {
+    WriteIdle();
+}
+
+void ReplayWriter::Flush(std::ostream& out) {
+    if (flushed < data.size()) {
+        out.write((const char*)data.data() + flushed, (std::streamsize)(data.size() - flushed));
+        flushed = data.size();
+    }
+}
+
+void ReplayWriter::WriteIdle() {
+    if (idleTicks > 0) {
+        WriteVarint(data, (uint64_t)idleTicks << 7);
+        idleTicks = 0;
+    }
+}
+
+void ReplayWriter::WriteKeyframe(const Simulation& game) {
+    Snapshot state;
+    game.Save(state);
+
+    WriteVarint(data, 0);
+    EncodeSnapshot(state, data);
+}
+
+void ReplayWriter::EncodeSnapshot(const Snapshot& state, std::vector<uint8_t>& out) {
+    WriteVarint(out, state.tick);
+    WriteVarint(out, (uint64_t)state.score);
+    WriteVarint(out, (uint64_t)state.level);
+    WriteVarint(out, (uint64_t)state.totalLinesCleared);
+    out.push_back(state.gameOver ? 1 : 0);
+    WriteVarint(out, (uint64_t)state.gravityCounter);
+
+    const Block& current = state.currentBlock;
+    out.push_back((uint8_t)current.id);
+    out.push_back((uint8_t)current.GetRotation());
+    WriteVarint(out, ZigZag(current.GetRow()));
+    WriteVarint(out, ZigZag(current.GetColumn()));
+    out.push_back((uint8_t)state.nextBlock.id);
+
+    const PieceBag& bag = state.bag;
+    WriteLittleEndian(out, bag.rngState, 8);
+    out.push_back(bag.bagMask);
+    out.push_back(bag.queueCount);
+    for (int i = 0; i < bag.queueCount; i++) {
+        out.push_back(bag.queue[(bag.queueHead + i) & 15]);
+    }
+
+    for (int row = 0; row < Grid::NUM_ROWS; row++) {
+        uint32_t colors = 0;
+        for (int column = 0; column < Grid::NUM_COLUMNS; column++) {
+            colors |= (uint32_t)state.grid.GetCell(row, column) << (column * 3);
+        }
+        WriteVarint(out, colors);
+    }
+}
+
+// --- READER ---
+
+ReplayReader::ReplayReader()
+    : data(nullptr), size(0), seed(0), keyframeInterval(0), length(0),
+      pos(0), tick(0), pendingIdle(0), pendingBits(0), hasPendingTick(false) {}
+
+InputState ReplayReader::DecodeInput(uint8_t bits) {
+    InputState input = {};
+    input.left = (bits & REPLAY_LEFT) != 0;
+    input.right = (bits & REPLAY_RIGHT) != 0;
+    input.down = (bits & REPLAY_DOWN) != 0;
+    input.rotate = (bits & REPLAY_ROTATE) != 0;
+    input.hardDrop = (bits & REPLAY_HARD_DROP) != 0;
+    input.reset = (bits & REPLAY_RESET) != 0;
+    return input;
+}
+
+bool ReplayReader::Open(const uint8_t* data, size_t size) {
+    this->data = data;
+    this->size = size;
+    keyframes.clear();
+    length = 0;
+
+    if (size < ReplayWriter::HEADER_SIZE) return false;
+    for (int i = 0; i < 4; i++) {
+        if (data[i] != MAGIC[i]) return false;
+    }
+    if (ReadLittleEndian(data + 4, 2) != ReplayWriter::VERSION) return false;
+    keyframeInterval = (int)ReadLittleEndian(data + 6, 2);
+    seed = (uint32_t)ReadLittleEndian(data + 8, 4);
+
+    // Single pass over the records: count the ticks and index the keyframes.
+    // A truncated trailing record (file still being written) simply ends the recording.
+    size_t cursor = ReplayWriter::HEADER_SIZE;
+    uint64_t tag;
+    while (ReadTag(cursor, tag)) {
+        if (tag == 0) {
+            size_t body = cursor;
+            uint64_t keyframeTick;
+            if (!ReadKeyframe(cursor, nullptr, keyframeTick) || keyframeTick != length) break;
+            keyframes.push_back({keyframeTick, body});
+        }
+        else {
+            length += (tag >> 7) + ((tag & TICK_BITS_MASK) ? 1 : 0);
+        }
+    }
+
+    // Every valid recording starts with the tick 0 keyframe
+    return !keyframes.empty();
+}
+
+bool ReplayReader::ReadTag(size_t& cursor, uint64_t& tag) const {
+    return ReadVarint(data, size, cursor, tag);
+}
+
+bool ReplayReader::ReadKeyframe(size_t& cursor, Snapshot* state, uint64_t& keyframeTick) const {
+    if (!DecodeSnapshot(data, size, cursor, state, keyframeTick)) return false;
+    if (state) state->seed = seed;
+    return true;
+}
+
+bool ReplayReader::DecodeSnapshot(const uint8_t* data, size_t size, size_t& cursor, Snapshot* state, uint64_t& keyframeTick) {
+    uint64_t score, level, lines, gravityCounter, row, column;
+    if (!ReadVarint(data, size, cursor, keyframeTick) || !ReadVarint(data, size, cursor, score) ||
+        !ReadVarint(data, size, cursor, level) || !ReadVarint(data, size, cursor, lines)) return false;
+    if (cursor + 1 > size) return false;
+    bool gameOver = data[cursor++] != 0;
+    if (!ReadVarint(data, size, cursor, gravityCounter)) return false;
+
+    if (cursor + 2 > size) return false;
+    int currentId = data[cursor++];
+    int rotation = data[cursor++];
+    if (!ReadVarint(data, size, cursor, row) || !ReadVarint(data, size, cursor, column)) return false;
+    if (cursor + 11 > size) return false;
+    int nextId = data[cursor++];
+    if (currentId > 7 || nextId > 7 || rotation >= Block::NUM_ROTATIONS) return false;
+
+    // States also come from remote peers: the falling piece must stay within [-3, NUM_ROWS) x [-3, NUM_COLUMNS)
+    if (row >= 2 * Grid::NUM_ROWS || column >= 2 * Grid::NUM_COLUMNS) return false;
+    int pieceRow = UnZigZag(row), pieceColumn = UnZigZag(column);
+    if (pieceRow < -3 || pieceColumn < -3) return false;
+
+    uint64_t rngState = ReadLittleEndian(data + cursor, 8);
+    cursor += 8;
+    uint8_t bagMask = data[cursor++];
+    uint8_t queueCount = data[cursor++];
+    if (bagMask > 0x7F || queueCount > PieceBag::MAX_PREVIEW || cursor + queueCount > size) return false;
+    const uint8_t* queue = data + cursor;
+    cursor += queueCount;
+    for (int i = 0; i < queueCount; i++) {
+        if (queue[i] < 1 || queue[i] > 7) return false;
+    }
+
+    Grid grid;
+    grid.Initalize();
+    for (int r = 0; r < Grid::NUM_ROWS; r++) {
+        uint64_t colors;
+        if (!ReadVarint(data, size, cursor, colors)) return false;
+        for (int c = 0; c < Grid::NUM_COLUMNS; c++) {
+            int id = (int)(colors >> (c * 3)) & 0x7;
+            if (id != 0) grid.SetCell(r, c, id);
+        }
+    }
+
+    // Only a game that is over may have its piece overlapping the stack (the spawn that ended it)
+    Block current = MakeBlock(currentId, rotation, pieceRow, pieceColumn);
+    if (!gameOver && !grid.PieceFits(current.id, current.GetRotation(), current.GetRow(), current.GetColumn())) return false;
+
+    if (state == nullptr) return true;
+
+    state->tick = keyframeTick;
+    state->score = (int32_t)score;
+    state->level = (int32_t)level;
+    state->totalLinesCleared = (int32_t)lines;
+    state->gameOver = gameOver;
+    state->gravityCounter = (int32_t)gravityCounter;
+    state->currentBlock = current;
+    state->nextBlock = (nextId != 0) ? CreateBlock(nextId) : Block();
+
+    state->bag.rngState = rngState;
+    state->bag.bagMask = bagMask;
+    state->bag.queueHead = 0;
+    state->bag.queueCount = queueCount;
+    for (int i = 0; i < queueCount; i++) state->bag.queue[i] = queue[i];
+    state->grid = grid;
+    return true;
+}
+
+bool ReplayReader::Start(Simulation& game) {
+    return Seek(game, 0);
+}
+
+bool ReplayReader::Step(Simulation& game) {
+    while (!hasPendingTick && pendingIdle == 0) {
+        uint64_t tag;
+        if (!ReadTag(pos, tag)) return false;
+
+        if (tag == 0) {
+            // Keyframes only matter for seeking
+            uint64_t keyframeTick;
+            if (!ReadKeyframe(pos, nullptr, keyframeTick)) return false;
+            continue;
+        }
+        pendingIdle = tag >> 7;
+        pendingBits = (uint8_t)(tag & TICK_BITS_MASK);
+        hasPendingTick = pendingBits != 0;
+    }
+
+    if (pendingIdle > 0) {
+        pendingIdle--;
+        game.ReplayTick(InputState{}, false);
+    }
+    else {
+        hasPendingTick = false;
+        game.ReplayTick(DecodeInput(pendingBits), (pendingBits & REPLAY_GRAVITY) != 0);
+    }
+    tick++;
+    return true;
+}
+
+bool ReplayReader::Seek(Simulation& game, uint64_t targetTick) {
+    if (keyframes.empty() || targetTick > length) return false;
+
+    // Last keyframe at or before the target (keyframes are in tick order)
+    size_t k = keyframes.size() - 1;
+    while (keyframes[k].tick > targetTick) k--;
+
+    pos = keyframes[k].offset;
+    uint64_t keyframeTick;
+    Snapshot state;
+    if (!ReadKeyframe(pos, &state, keyframeTick)) return false;
+    game.Restore(state);
+
+    tick = keyframeTick;
+    pendingIdle = 0;
+    hasPendingTick = false;
+    while (tick < targetTick) {
+        if (!Step(game)) return false;
+    }
+    return true;
+}
+
+uint64_t ReplayReader::PlayToEnd(Simulation& game) {
+    uint64_t played = 0;
+    while (Step(game)) played++;
+    return played;
+}
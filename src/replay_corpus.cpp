@@ -0,0 +1,218 @@
+/**
+ * @file replay_corpus.cpp
+ * @brief Implementation of the ReplayCorpusWriter and ReplayCorpus classes.
+ */
+
+// 1. Platform file mapping APIs
+#if defined(_WIN32)
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "../include/replay_corpus.hpp"
+#include <cstring>
+
+static const uint8_t MAGIC[4] = {'T', 'R', 'P', 'C'};
+
+// --- LOCAL HELPER FUNCTIONS ---
+
+static void PutLittleEndian(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint64_t GetLittleEndian(const uint8_t* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint64_t)data[i] << (8 * i);
+    return value;
+}
+
+static bool IsLittleEndianHost() {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+// --- WRITER ---
+
+ReplayCorpusWriter::~ReplayCorpusWriter() {
+    Close();
+}
+
+bool ReplayCorpusWriter::Open(const std::string& path) {
+    Close();
+    entries.clear();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    // Placeholder header, completed by Close once the index location is known
+    uint8_t header[HEADER_SIZE] = {0};
+    file.write((const char*)header, HEADER_SIZE);
+    offset = HEADER_SIZE;
+    return (bool)file;
+}
+
+bool ReplayCorpusWriter::Add(const uint8_t* replay, size_t size) {
+    if (!file.is_open()) return false;
+
+    ReplayReader reader;
+    if (!reader.Open(replay, size)) return false;
+
+    Simulation game;
+    reader.Start(game);
+    reader.PlayToEnd(game);
+
+    CorpusEntry entry = {};
+    entry.offset = offset;
+    entry.size = (uint32_t)size;
+    entry.seed = reader.GetSeed();
+    entry.score = (uint32_t)game.score;
+    entry.level = (uint16_t)game.level;
+    entry.linesCleared = (uint32_t)game.totalLinesCleared;
+    entry.ticks = (uint32_t)reader.GetLength();
+    entries.push_back(entry);
+
+    file.write((const char*)replay, (std::streamsize)size);
+    offset += size;
+    return (bool)file;
+}
+
+bool ReplayCorpusWriter::Close() {
+    if (!file.is_open()) return false;
+
+    // Index after the data, 8-byte aligned so it can be read in place from the mapping
+    static const uint8_t padding[8] = {0};
+    uint64_t indexOffset = (offset + 7) & ~(uint64_t)7;
+    file.write((const char*)padding, (std::streamsize)(indexOffset - offset));
+
+    for (const CorpusEntry& e : entries) {
+        uint8_t record[sizeof(CorpusEntry)];
+        PutLittleEndian(record + 0, e.offset, 8);
+        PutLittleEndian(record + 8, e.size, 4);
+        PutLittleEndian(record + 12, e.seed, 4);
+        PutLittleEndian(record + 16, e.score, 4);
+        PutLittleEndian(record + 20, e.level, 2);
+        PutLittleEndian(record + 22, 0, 2);
+        PutLittleEndian(record + 24, e.linesCleared, 4);
+        PutLittleEndian(record + 28, e.ticks, 4);
+        file.write((const char*)record, sizeof(record));
+    }
+
+    uint8_t header[HEADER_SIZE] = {0};
+    memcpy(header, MAGIC, 4);
+    PutLittleEndian(header + 4, VERSION, 2);
+    PutLittleEndian(header + 6, sizeof(CorpusEntry), 2);
+    PutLittleEndian(header + 8, entries.size(), 4);
+    PutLittleEndian(header + 16, indexOffset, 8);
+    file.seekp(0);
+    file.write((const char*)header, HEADER_SIZE);
+
+    bool ok = (bool)file;
+    file.close();
+    return ok;
+}
+
+// --- READER ---
+
+ReplayCorpus::ReplayCorpus()
+    : base(nullptr), size(0), entries(nullptr), count(0), fileHandle(nullptr), mappingHandle(nullptr) {}
+
+ReplayCorpus::~ReplayCorpus() {
+    Close();
+}
+
+bool ReplayCorpus::Open(const std::string& path) {
+    Close();
+
+    // The index is used in place, which assumes the file's byte order
+    if (!IsLittleEndianHost()) return false;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { Close(); return false; }
+    size = (size_t)fileSize.QuadPart;
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) { Close(); return false; }
+    mappingHandle = mapping;
+
+    base = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (base == nullptr) { Close(); return false; }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    fileHandle = (void*)(intptr_t)(fd + 1); // +1 so descriptor 0 is not mistaken for "no file"
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) { Close(); return false; }
+    size = (size_t)info.st_size;
+
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) { Close(); return false; }
+    base = (const uint8_t*)view;
+#endif
+
+    // Validate the header and that the whole index lies inside the file
+    if (size < ReplayCorpusWriter::HEADER_SIZE || memcmp(base, MAGIC, 4) != 0 ||
+        GetLittleEndian(base + 4, 2) != ReplayCorpusWriter::VERSION ||
+        GetLittleEndian(base + 6, 2) != sizeof(CorpusEntry)) {
+        Close();
+        return false;
+    }
+    uint64_t gameCount = GetLittleEndian(base + 8, 4);
+    uint64_t indexOffset = GetLittleEndian(base + 16, 8);
+    if ((indexOffset & 7) != 0 || indexOffset > size || gameCount > (size - indexOffset) / sizeof(CorpusEntry)) {
+        Close();
+        return false;
+    }
+
+    entries = (const CorpusEntry*)(base + indexOffset);
+    count = (size_t)gameCount;
+    return true;
+}
+
+void ReplayCorpus::Close() {
+#if defined(_WIN32)
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+#else
+    if (base) munmap((void*)base, size);
+    if (fileHandle) close((int)(intptr_t)fileHandle - 1);
+#endif
+    base = nullptr;
+    size = 0;
+    entries = nullptr;
+    count = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+std::vector<uint32_t> ReplayCorpus::Query(const CorpusQuery& query) const {
+    std::vector<uint32_t> matches;
+    for (size_t i = 0; i < count; i++) {
+        const CorpusEntry& e = entries[i];
+        if ((int)e.level >= query.minLevel && (int)e.level <= query.maxLevel &&
+            (int64_t)e.score >= query.minScore && (int64_t)e.score <= query.maxScore &&
+            (int64_t)e.linesCleared >= query.minLines && (int64_t)e.linesCleared <= query.maxLines) {
+            matches.push_back((uint32_t)i);
+        }
+    }
+    return matches;
+}
+
+bool ReplayCorpus::OpenReplay(size_t index, ReplayReader& reader) const {
+    if (index >= count) return false;
+    const CorpusEntry& e = entries[index];
+    if (e.offset > size || e.size > size - e.offset) return false;
+    return reader.Open(base + e.offset, e.size);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file rollback_session.cpp
+ * @brief Implementation of the RollbackSession class.
+ */
+
+#include "../include/rollback_session.hpp"
+#include <algorithm>
+
+// --- LOCAL HELPER FUNCTIONS ---
+
+// Inputs match if the same buttons are pressed (currentScore is not part of the simulation)
+static bool SameButtons(const InputState& a, const InputState& b) {
+    return a.left == b.left && a.right == b.right && a.down == b.down &&
+           a.rotate == b.rotate && a.hardDrop == b.hardDrop && a.reset == b.reset;
+}
+
+// --- CONSTRUCTOR ---
+
+RollbackSession::RollbackSession()
+    : frame(0), confirmedFrame(0), predictedFrom(0), desynced(false), desyncFrame(0) {}
+
+void RollbackSession::Start() {
+    inputs.clear();
+    checksums.clear();
+    remoteChecksums.clear();
+    frame = 0;
+    confirmedFrame = 0;
+    predictedFrom = 0;
+    desynced = false;
+}
+
+bool RollbackSession::Resync(uint32_t startFrame) {
+    // Frames from 'startFrame' up to the confirmed one run again with the kept inputs
+    if (startFrame + RESYNC_HISTORY_FRAMES < confirmedFrame) return false;
+    while (!inputs.empty() && inputs.front().frame < startFrame) inputs.pop_front();
+    frame = startFrame;
+    confirmedFrame = std::max(confirmedFrame, startFrame);
+    predictedFrom = startFrame;
+
+    checksums.clear();
+    while (!remoteChecksums.empty() && remoteChecksums.front().frame < startFrame) remoteChecksums.pop_front();
+    desynced = false;
+    return true;
+}
+
+// --- REMOTE INPUT ---
+
+bool RollbackSession::AddInput(uint32_t inputFrame, InputState input) {
+    if (inputFrame < confirmedFrame) return false; // Already known (inputs are sent redundantly)
+    inputs.push_back({ inputFrame, input });
+    confirmedFrame = inputFrame + 1;
+    return true;
+}
+
+void RollbackSession::Confirm(uint32_t remoteFrame) {
+    confirmedFrame = std::max(confirmedFrame, remoteFrame);
+}
+
+void RollbackSession::AddChecksum(uint32_t checksumFrame, uint64_t checksum) {
+    // Resent copies: a confirmed frame was already compared, a newer one is already queued
+    if (checksumFrame < confirmedFrame) return;
+    if (!remoteChecksums.empty() && checksumFrame <= remoteChecksums.back().frame) return;
+    remoteChecksums.push_back({ checksumFrame, checksum });
+}
+
+InputState RollbackSession::GetInput(uint32_t inputFrame, size_t& cursor) const {
+    while (cursor < inputs.size() && inputs[cursor].frame < inputFrame) cursor++;
+    if (cursor < inputs.size() && inputs[cursor].frame == inputFrame) return inputs[cursor].input;
+    return InputState{};
+}
+
+// --- SIMULATION ---
+
+void RollbackSession::Step(Simulation& board, InputState input) {
+    // Confirmed frames can never be rolled back: no snapshot needed
+    if (frame >= confirmedFrame) {
+        FrameState& slot = ring[frame % MAX_ROLLBACK_FRAMES];
+        board.Save(slot.state);
+        slot.input = input;
+    }
+
+    // A frame simulated again after a rollback replaces its checksum
+    if (frame % CHECKSUM_INTERVAL == 0) {
+        while (!checksums.empty() && checksums.back().frame >= frame) checksums.pop_back();
+        checksums.push_back({ frame, board.GetChecksum() });
+    }
+    board.Tick(input);
+    frame++;
+}
+
+bool RollbackSession::Advance(Simulation& board, uint32_t targetFrame) {
+    // 1. Check the predictions of the frames confirmed since the last call
+    size_t cursor = 0;
+    uint32_t checkedEnd = std::min(frame, confirmedFrame);
+    for (uint32_t f = predictedFrom; f < checkedEnd; f++) {
+        if (SameButtons(ring[f % MAX_ROLLBACK_FRAMES].input, GetInput(f, cursor))) continue;
+
+        // Misprediction: back to the state before that frame
+        uint32_t depth = frame - f;
+        board.Restore(ring[f % MAX_ROLLBACK_FRAMES].state);
+        frame = f;
+        stats.rollbacks++;
+        stats.resimulatedFrames += depth;
+        stats.maxDepth = std::max(stats.maxDepth, depth);
+        break;
+    }
+
+    // 2. Run the confirmed frames, then predict up to the target (never past the ring)
+    cursor = 0;
+    while (frame < confirmedFrame) Step(board, GetInput(frame, cursor));
+
+    uint32_t limit = std::min(targetFrame, confirmedFrame + MAX_ROLLBACK_FRAMES - 1);
+    while (frame < limit) {
+        Step(board, GetInput(frame, cursor));
+        stats.predictedFrames++;
+    }
+    predictedFrom = confirmedFrame;
+
+    // 3. Inputs of confirmed frames are final, only kept for a late Resync
+    while (!inputs.empty() && inputs.front().frame + RESYNC_HISTORY_FRAMES < confirmedFrame) inputs.pop_front();
+
+    // 4. So is the state before them
+    return VerifyChecksums();
+}
+
+bool RollbackSession::VerifyChecksums() {
+    // The owner sends the checksum of frame f before any message confirming f, so once f is
+    // confirmed a missing checksum will not come any more
+    while (!checksums.empty() && checksums.front().frame < confirmedFrame) {
+        FrameChecksum local = checksums.front();
+        while (!remoteChecksums.empty() && remoteChecksums.front().frame < local.frame) remoteChecksums.pop_front();
+        if (remoteChecksums.empty() || remoteChecksums.front().frame != local.frame) {
+            checksums.pop_front();
+            continue;
+        }
+
+        uint64_t remote = remoteChecksums.front().checksum;
+        checksums.pop_front();
+        remoteChecksums.pop_front();
+        if (desynced) continue; // Known to differ until Resync
+        if (remote == local.checksum) {
+            stats.checksumsVerified++;
+            continue;
+        }
+
+        desynced = true;
+        desyncFrame = local.frame;
+        stats.desyncs++;
+        return true;
+    }
+    return false;
+}
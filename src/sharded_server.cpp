@@ -0,0 +1,220 @@
+/**
+ * @file sharded_server.cpp
+ * @brief Implementation of the ShardedServer class.
+ */
+
+// 1. Windows-specific protection definitions
+#if defined(_WIN32)
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+#include <enet/enet.h>
+#include "../include/sharded_server.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// --- CONSTRUCTOR / DESTRUCTOR ---
+
+ShardedServer::ShardedServer()
+    : lobby(nullptr), waiting(nullptr), running(false), tokenGenerator(std::random_device{}()) {
+    if (enet_initialize() != 0) {
+        std::cerr << "[Server] Error initializing ENet!\n";
+    }
+}
+
+ShardedServer::~ShardedServer() {
+    Stop();
+    enet_deinitialize();
+}
+
+// --- CONNECTION MANAGEMENT ---
+
+bool ShardedServer::Start(int port, int numShards, int clientsPerShard) {
+    Stop();
+    if (numShards <= 0) numShards = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    ENetAddress address;
+    address.host = ENET_HOST_ANY;
+    address.port = (enet_uint16)port;
+
+    // The lobby only holds players until they are paired
+    lobby = enet_host_create(&address, (size_t)clientsPerShard, CHANNEL_COUNT, 0, 0);
+    if (!lobby) return false;
+
+    // Each shard owns its host from here on; it is only touched by its thread
+    for (int i = 0; i < numShards; i++) {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->port = port + 1 + i;
+        shard->server.useSameSeeds = useSameSeeds;
+        shard->server.pairOnConnect = false;
+        shard->server.SetSendRate(sendRate);
+        if (!shard->server.Start(shard->port, clientsPerShard)) {
+            std::cerr << "[Server] Could not open shard port " << shard->port << "\n";
+            Stop();
+            return false;
+        }
+        shards.push_back(std::move(shard));
+    }
+
+    running = true;
+    for (const std::unique_ptr<Shard>& shard : shards) {
+        shard->thread = std::thread(&ShardedServer::RunShard, this, std::ref(*shard));
+    }
+    return true;
+}
+
+void ShardedServer::Stop() {
+    running = false;
+    for (const std::unique_ptr<Shard>& shard : shards) {
+        if (shard->thread.joinable()) shard->thread.join();
+        shard->server.Stop();
+    }
+    shards.clear();
+
+    if (lobby) {
+        if (waiting) enet_peer_disconnect(waiting, 0);
+        enet_host_flush(lobby);
+        enet_host_destroy(lobby);
+    }
+    lobby = nullptr;
+    waiting = nullptr;
+}
+
+// --- LOBBY ---
+
+void ShardedServer::Send(ENetPeer* peer, const NetMessage& message) {
+    uint8_t buffer[WireProtocol::MAX_MESSAGE_SIZE];
+    size_t length = WireProtocol::Encode(message, buffer);
+    enet_peer_send(peer, 0, enet_packet_create(buffer, length, ENET_PACKET_FLAG_RELIABLE));
+}
+
+void ShardedServer::Update(uint32_t waitMs) {
+    if (!lobby) return;
+    ENetEvent event;
+
+    while (enet_host_service(lobby, &event, waitMs) > 0) {
+        waitMs = 0;
+
+        if (event.type == ENET_EVENT_TYPE_CONNECT) {
+            // Matches are only known to their shard: spectators connect to its port
+            if (event.data == CONNECT_SPECTATOR) {
+                Send(event.peer, WireProtocol::Make(PACKET_QUIT));
+                enet_peer_disconnect(event.peer, 0);
+                continue;
+            }
+            if (!waiting) {
+                waiting = event.peer;
+                waitingSince = std::chrono::steady_clock::now();
+                continue;
+            }
+
+            ENetPeer* first = waiting;
+            waiting = nullptr;
+            if (!Dispatch(first, event.peer)) {
+                // Every shard is backed up: turn both players away
+                for (ENetPeer* player : { first, event.peer }) {
+                    Send(player, WireProtocol::Make(PACKET_QUIT));
+                    enet_peer_disconnect(player, 0);
+                }
+            }
+        }
+        else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+            // Nothing is played in the lobby
+            enet_packet_destroy(event.packet);
+        }
+        else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
+            if (event.peer == waiting) waiting = nullptr;
+        }
+    }
+
+    // Nobody came: the waiting player goes to play a shard's bot
+    if (waiting && botWaitSeconds >= 0 &&
+        std::chrono::steady_clock::now() - waitingSince >= std::chrono::duration<double>(botWaitSeconds)) {
+        ENetPeer* player = waiting;
+        waiting = nullptr;
+        if (!Dispatch(player, nullptr)) {
+            Send(player, WireProtocol::Make(PACKET_QUIT));
+            enet_peer_disconnect(player, 0);
+        }
+    }
+}
+
+bool ShardedServer::Dispatch(ENetPeer* first, ENetPeer* second) {
+    // Least loaded shard first; a full queue (stalled shard) falls through to the next best
+    std::vector<Shard*> order;
+    for (const std::unique_ptr<Shard>& shard : shards) order.push_back(shard.get());
+    std::sort(order.begin(), order.end(), [](const Shard* a, const Shard* b) {
+        return a->load.load(std::memory_order_relaxed) < b->load.load(std::memory_order_relaxed);
+    });
+
+    MatchTicket ticket;
+    for (uint64_t& token : ticket.tokens) {
+        do { token = tokenGenerator(); } while (token == 0); // 0 means "no token" on the client
+    }
+    if (!second) ticket.tokens[1] = 0; // The shard's bot takes the second slot
+
+    for (Shard* shard : order) {
+        if (!shard->tickets.Push(ticket)) continue;
+        shard->load.fetch_add(1, std::memory_order_relaxed);
+
+        ENetPeer* players[2] = { first, second };
+        for (int slot = 0; slot < 2; slot++) {
+            if (!players[slot]) continue;
+            NetMessage redirect = WireProtocol::Make(PACKET_REDIRECT);
+            redirect.port = (uint16_t)shard->port;
+            redirect.token = ticket.tokens[slot];
+            Send(players[slot], redirect);
+        }
+        return true;
+    }
+    return false;
+}
+
+// --- SHARDS ---
+
+void ShardedServer::RunShard(Shard& shard) {
+    auto last = std::chrono::steady_clock::now();
+    while (running.load(std::memory_order_relaxed)) {
+        MatchTicket ticket;
+        while (shard.tickets.Pop(ticket)) shard.server.AddTicket(ticket);
+
+        // 1 ms wait keeps relayed inputs within a millisecond of their arrival
+        auto now = std::chrono::steady_clock::now();
+        shard.server.Update(std::chrono::duration<double>(now - last).count(), 1);
+        last = now;
+
+        shard.load.store((int)(shard.server.GetMatchCount() + shard.server.GetPendingTicketCount()), std::memory_order_relaxed);
+        shard.framesSimulated.store(shard.server.GetFramesSimulated(), std::memory_order_relaxed);
+        shard.packetsSent.store(shard.server.GetBatcher().GetPacketsSent(), std::memory_order_relaxed);
+        shard.spectators.store(shard.server.GetSpectatorCount(), std::memory_order_relaxed);
+    }
+}
+
+size_t ShardedServer::GetMatchCount() const {
+    size_t total = 0;
+    for (const std::unique_ptr<Shard>& shard : shards) total += shard->load.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t ShardedServer::GetFramesSimulated() const {
+    uint64_t total = 0;
+    for (const std::unique_ptr<Shard>& shard : shards) total += shard->framesSimulated.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t ShardedServer::GetPacketsSent() const {
+    uint64_t total = 0;
+    for (const std::unique_ptr<Shard>& shard : shards) total += shard->packetsSent.load(std::memory_order_relaxed);
+    return total;
+}
+
+size_t ShardedServer::GetSpectatorCount() const {
+    size_t total = 0;
+    for (const std::unique_ptr<Shard>& shard : shards) total += shard->spectators.load(std::memory_order_relaxed);
+    return total;
+}
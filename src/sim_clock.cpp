@@ -0,0 +1,31 @@
+/**
+ * @file sim_clock.cpp
+ * @brief Implementation of the SimClock class.
+ */
+
+#include "../include/sim_clock.hpp"
+
+SimClock::SimClock()
+    : timeScale(1.0), maxCatchUpTicks(5), accumulator(0.0), ticks(0) {}
+
+int SimClock::Advance(double elapsedSeconds) {
+    if (elapsedSeconds > 0) accumulator += elapsedSeconds * timeScale;
+
+    // The small epsilon keeps a frame of exactly one tick from rounding down to zero ticks
+    int due = (int)((accumulator + 1e-9) / TICK_SECONDS);
+    if (due > maxCatchUpTicks) {
+        // Too far behind: run the maximum and forget the rest
+        due = maxCatchUpTicks;
+        accumulator = 0.0;
+    }
+    else {
+        accumulator -= due * TICK_SECONDS;
+    }
+
+    ticks += due;
+    return due;
+}
+
+void SimClock::Reset() {
+    accumulator = 0.0;
+}
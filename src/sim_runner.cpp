@@ -0,0 +1,164 @@
+/**
+ * @file sim_runner.cpp
+ * @brief Implementation of the SimRunner class.
+ *
+ * Scheduling: the job list is cut into fixed-size chunks that are dealt round-robin
+ * into one deque per worker. A worker pops chunks from the back of its own deque and,
+ * once it runs dry, steals from the front of another worker's deque. Each worker keeps
+ * its own Simulation and result histograms, which are merged once at the end, so the
+ * only shared state touched while playing is a short per-deque lock.
+ */
+
+#include "../include/sim_runner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Games per scheduling unit: large enough to keep lock traffic negligible,
+// small enough to balance load when game lengths vary widely.
+static const size_t CHUNK_SIZE = 64;
+
+// --- LOCAL HELPER FUNCTIONS ---
+
+static uint64_t NextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Per-worker queue of [begin, end) job ranges
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<std::pair<size_t, size_t>> chunks;
+};
+
+// Pops from the worker's own queue first, then tries to steal from the others.
+static bool TakeChunk(std::vector<WorkQueue>& queues, int self, std::pair<size_t, size_t>& chunk) {
+    {
+        std::lock_guard<std::mutex> guard(queues[self].lock);
+        if (!queues[self].chunks.empty()) {
+            chunk = queues[self].chunks.back();
+            queues[self].chunks.pop_back();
+            return true;
+        }
+    }
+    int count = (int)queues.size();
+    for (int i = 1; i < count; i++) {
+        WorkQueue& victim = queues[(self + i) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- DISTRIBUTION ---
+
+void Distribution::Add(int value) {
+    counts[value]++;
+    count++;
+    sum += value;
+}
+
+void Distribution::Merge(const Distribution& other) {
+    for (const auto& entry : other.counts) {
+        counts[entry.first] += entry.second;
+    }
+    count += other.count;
+    sum += other.sum;
+}
+
+int Distribution::Percentile(double fraction) const {
+    uint64_t target = (uint64_t)(fraction * count);
+    uint64_t seen = 0;
+    for (const auto& entry : counts) {
+        seen += entry.second;
+        if (seen >= target && seen > 0) return entry.first;
+    }
+    return Max();
+}
+
+// --- RUNNER ---
+
+SimRunner::SimRunner(int numThreads) {
+    if (numThreads <= 0) numThreads = (int)std::thread::hardware_concurrency();
+    this->numThreads = std::max(1, numThreads);
+}
+
+int SimRunner::AddPolicy(BotPolicy policy) {
+    policies.push_back(policy);
+    return (int)policies.size() - 1;
+}
+
+InputState SimRunner::RandomPolicy(const Simulation&, uint64_t& rngState) {
+    uint64_t r = NextRandom(rngState);
+    InputState input = {};
+    input.left = (r & 0x7) == 0;
+    input.right = ((r >> 3) & 0x7) == 0;
+    input.rotate = ((r >> 6) & 0xF) == 0;
+    input.down = ((r >> 10) & 0x3) == 0;
+    input.hardDrop = ((r >> 12) & 0x3F) == 0;
+    return input;
+}
+
+RunnerResults SimRunner::Run(const std::vector<SimJob>& jobs, int maxFramesPerGame) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Deal the jobs round-robin so every worker starts with a similar share
+    std::vector<WorkQueue> queues(numThreads);
+    size_t chunkIndex = 0;
+    for (size_t begin = 0; begin < jobs.size(); begin += CHUNK_SIZE, chunkIndex++) {
+        size_t end = std::min(jobs.size(), begin + CHUNK_SIZE);
+        queues[chunkIndex % numThreads].chunks.push_back({begin, end});
+    }
+
+    std::vector<RunnerResults> partial(numThreads);
+    std::vector<std::thread> workers;
+
+    for (int w = 0; w < numThreads; w++) {
+        workers.emplace_back([&, w]() {
+            Simulation game;
+            RunnerResults& out = partial[w];
+            std::pair<size_t, size_t> chunk;
+
+            while (TakeChunk(queues, w, chunk)) {
+                for (size_t j = chunk.first; j < chunk.second; j++) {
+                    const SimJob& job = jobs[j];
+                    BotPolicy policy = policies[job.policy];
+                    uint64_t policyState = job.seed;
+
+                    game.Reset((int)job.seed);
+                    int frame = 0;
+                    while (!game.gameOver && frame < maxFramesPerGame) {
+                        game.Tick(policy(game, policyState));
+                        frame++;
+                    }
+
+                    out.gamesPlayed++;
+                    out.framesSimulated += frame;
+                    out.score.Add(game.score);
+                    out.level.Add(game.level);
+                    out.linesCleared.Add(game.totalLinesCleared);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    RunnerResults results;
+    for (const RunnerResults& p : partial) {
+        results.gamesPlayed += p.gamesPlayed;
+        results.framesSimulated += p.framesSimulated;
+        results.score.Merge(p.score);
+        results.level.Merge(p.level);
+        results.linesCleared.Merge(p.linesCleared);
+    }
+    results.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return results;
+}
\ No newline at end of file
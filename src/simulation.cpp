@@ -0,0 +1,295 @@
+/**
+ * @file simulation.cpp
+ * @brief Implementation of the Simulation class (headless game rules).
+ */
+
+#include "../include/simulation.hpp"
+#include "../include/replay.hpp"
+#include "../include/zobrist.hpp"
+#include <cmath>
+#include <ctime>
+
+Simulation::Simulation() {
+    grid = Grid();
+    Reset();
+}
+
+// --- LOGIC: Block Management ---
+
+Block Simulation::GetRandomBlock() {
+    // Take the next piece of the instance-specific 7-bag
+    return CreateBlock(bag.Next());
+}
+
+// --- LOGIC: Collision & Movement ---
+
+int Simulation::GetGhostRow() {
+    if (ghostDirty) {
+        ghostRow = currentBlock.GetRow() + grid.GetDropDistance(currentBlock.id, currentBlock.GetRotation(), currentBlock.GetRow(), currentBlock.GetColumn());
+        ghostDirty = false;
+    }
+    return ghostRow;
+}
+
+bool Simulation::BlockFits(const Block& block) const {
+    return grid.PieceFits(block.id, block.GetRotation(), block.GetRow(), block.GetColumn());
+}
+
+void Simulation::HandleInput(InputState input) {
+    if (gameOver) { 
+        if (input.reset) { Reset(); } 
+        return; 
+    }
+
+    if (input.left)   MoveBlockLeft();
+    if (input.right)  MoveBlockRight();
+    if (input.rotate) RotateBlock();
+    
+    if (input.hardDrop) {
+        HardDrop();
+    }
+    else if (input.down) { 
+        if (MoveBlockDown()) {
+            UpdateScore(0, 1); // 1 point for soft drop
+        }
+    }
+}
+
+// --- LOGIC: Fixed-Timestep Stepping ---
+
+bool Simulation::Tick(InputState input) {
+    HandleInput(input);
+    tick++;
+    bool gravity = StepGravity();
+    if (recorder) recorder->RecordTick(*this, input, gravity);
+    return gravity;
+}
+
+void Simulation::ReplayTick(InputState input, bool gravity) {
+    HandleInput(input);
+    tick++;
+
+    // Same counter updates as StepGravity, with the decision read from the recording
+    if (gravity) {
+        gravityCounter = 0;
+        MoveBlockDown();
+    }
+    else if (!gameOver) {
+        gravityCounter++;
+    }
+}
+
+bool Simulation::StepGravity() {
+    if (gameOver) return false;
+    if (++gravityCounter < GetGravityTicks()) return false;
+
+    gravityCounter = 0;
+    MoveBlockDown();
+    return true;
+}
+
+int Simulation::Update(double elapsedSeconds, InputState input, bool stopTimer) {
+    // Merge this frame's presses into the ones not yet consumed by a tick
+    pendingInput.left |= input.left;
+    pendingInput.right |= input.right;
+    pendingInput.down |= input.down;
+    pendingInput.rotate |= input.rotate;
+    pendingInput.hardDrop |= input.hardDrop;
+    pendingInput.reset |= input.reset;
+    pendingInput.currentScore = input.currentScore;
+
+    if (stopTimer) {
+        clock.Reset();
+        pendingInput = InputState{};
+        return 0;
+    }
+
+    int ticks = clock.Advance(elapsedSeconds);
+    for (int i = 0; i < ticks; i++) {
+        Tick(pendingInput);
+        pendingInput = InputState{};
+    }
+    return ticks;
+}
+
+int Simulation::GetGravityTicks() const {
+    // GetSpeed is in seconds per row
+    return (int)fmax(1.0, GetSpeed() * SimClock::TICK_RATE + 0.5);
+}
+
+uint64_t Simulation::GetStateHash() const {
+    return grid.GetHash() ^
+           Zobrist::Piece(currentBlock.id, currentBlock.GetRotation(), currentBlock.GetRow(), currentBlock.GetColumn()) ^
+           Zobrist::Next(nextBlock.id);
+}
+
+uint64_t Simulation::GetChecksum() const {
+    // Level follows from the lines; the tick is the frame the checksum is taken at
+    uint64_t scoring = (uint64_t)(uint32_t)score ^ ((uint64_t)(uint32_t)totalLinesCleared << 32) ^
+                       ((uint64_t)(uint32_t)gravityCounter << 48) ^ (gameOver ? 1ULL << 63 : 0);
+    return GetStateHash() ^ bag.GetChecksum() ^ Zobrist::Mix(scoring);
+}
+
+void Simulation::MoveBlockLeft() {
+    if(!gameOver){
+        // Test the candidate placement first, only commit the move if it fits
+        if (grid.PieceFits(currentBlock.id, currentBlock.GetRotation(), currentBlock.GetRow(), currentBlock.GetColumn() - 1)) {
+            currentBlock.Move(0, -1);
+            ghostDirty = true;
+        }
+    } 
+}
+
+void Simulation::MoveBlockRight(){
+    if(!gameOver){
+        if (grid.PieceFits(currentBlock.id, currentBlock.GetRotation(), currentBlock.GetRow(), currentBlock.GetColumn() + 1)) {
+            currentBlock.Move(0, 1);
+            ghostDirty = true;
+        }
+    }
+}
+
+bool Simulation::MoveBlockDown(){ 
+    if(!gameOver){
+        if (!grid.PieceFits(currentBlock.id, currentBlock.GetRotation(), currentBlock.GetRow() + 1, currentBlock.GetColumn())) {
+            LockBlock();
+            return false;
+        }
+        currentBlock.Move(1, 0);
+        return true;
+    }
+    return false;
+}
+
+void Simulation::HardDrop() {
+    if(!gameOver){
+        int distance = GetGhostRow() - currentBlock.GetRow();
+        currentBlock.Move(distance, 0);
+        UpdateScore(0, 2 * distance); // 2 points per row for hard drop
+        LockBlock();
+    }
+}
+
+void Simulation::RotateBlock() {
+    if(!gameOver){
+        // Check collision for the next rotation state, skip if invalid (Wall kick could be implemented here)
+        int nextRotation = (currentBlock.GetRotation() + 1) % Block::NUM_ROTATIONS;
+        if (grid.PieceFits(currentBlock.id, nextRotation, currentBlock.GetRow(), currentBlock.GetColumn())) {
+            currentBlock.Rotate();
+            ghostDirty = true;
+        }
+    }
+}
+
+// --- LOGIC: Game State & Scoring ---
+
+void Simulation::LockBlock() {
+    std::array<Position, 4> tiles = currentBlock.GetCellPositions();
+    for (Position item: tiles){
+        if(item.row >= 0) {
+            grid.SetCell(item.row, item.column, currentBlock.id);
+        }
+        else {
+            // Block locked above the visible grid area
+            gameOver = true;
+        }
+    }
+
+    ghostDirty = true;
+
+    if (!gameOver) {
+        currentBlock = nextBlock;
+        
+        // Immediate loss check upon spawning new block
+        if(!BlockFits(currentBlock)) {
+            gameOver = true;
+        }
+        
+        nextBlock = GetRandomBlock();
+        int rowsCleared = grid.ClearFullRows();
+        UpdateScore(rowsCleared, 0);
+    }
+}
+
+double Simulation::GetSpeed() const {
+    // Increase speed as level increases (capped at 0.05s)
+    return (double)fmax(0.05, 0.8 - ((level - 1) * 0.07)); 
+}
+
+void Simulation::Reset(int seed) {
+    grid.Initalize();
+    
+    // Seed RNG: Use provided seed (Multiplayer) or Time (Singleplayer)
+    this->seed = (seed != -1) ? (uint32_t)seed : (uint32_t)time(NULL);
+    bag.Reset(this->seed);
+
+    currentBlock = GetRandomBlock();
+    nextBlock = GetRandomBlock();
+    score = 0;
+    level = 1;
+    totalLinesCleared = 0;
+    gameOver = false;
+    ghostDirty = true;
+
+    tick = 0;
+    gravityCounter = 0;
+    pendingInput = InputState{};
+    clock.Reset();
+    recorder = nullptr;
+}
+
+// --- LOGIC: Snapshots ---
+
+void Simulation::Save(Snapshot& out) const {
+    out.grid = grid;
+    out.currentBlock = currentBlock;
+    out.nextBlock = nextBlock;
+    out.bag = bag;
+    out.tick = tick;
+    out.seed = seed;
+    out.score = score;
+    out.level = level;
+    out.totalLinesCleared = totalLinesCleared;
+    out.gravityCounter = gravityCounter;
+    out.gameOver = gameOver;
+}
+
+void Simulation::Restore(const Snapshot& in) {
+    grid = in.grid;
+    currentBlock = in.currentBlock;
+    nextBlock = in.nextBlock;
+    bag = in.bag;
+    tick = in.tick;
+    seed = in.seed;
+    score = in.score;
+    level = in.level;
+    totalLinesCleared = in.totalLinesCleared;
+    gravityCounter = in.gravityCounter;
+    gameOver = in.gameOver;
+
+    ghostDirty = true;
+    pendingInput = InputState{};
+    recorder = nullptr;
+}
+
+void Simulation::UpdateScore(int linesCleared, int moveDownPoints) {
+    score += GetLinePoints(linesCleared, level);
+    score += moveDownPoints; 
+    totalLinesCleared += linesCleared;
+    level = GetLevelForLines(totalLinesCleared);
+}
+
+int Simulation::GetLinePoints(int linesCleared, int level) {
+    // Classic Tetris scoring system
+    switch (linesCleared) {
+        case 1: return 100 * level;
+        case 2: return 300 * level;
+        case 3: return 500 * level;
+        case 4: return 800 * level;
+        default: return 0;
+    }
+}
+
+int Simulation::GetLevelForLines(int totalLines) {
+    return 1 + (totalLines / 10);
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+/**
+ * @file spectator.cpp
+ * @brief Implementation of the Spectator class.
+ */
+
+// 1. Windows-specific protection definitions
+#if defined(_WIN32)
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+#include <enet/enet.h>
+#include "../include/spectator.hpp"
+#include <iostream>
+
+// --- CONSTRUCTOR / DESTRUCTOR ---
+
+Spectator::Spectator()
+    : host(nullptr), peer(nullptr), matchId(0), isConnected(false), watching(false), ended(false),
+      rounds(0), framesSimulated(0) {
+    if (enet_initialize() != 0) {
+        std::cerr << "[Spectator] Error initializing ENet!\n";
+    }
+}
+
+Spectator::~Spectator() {
+    Stop();
+    enet_deinitialize();
+}
+
+// --- CONNECTION MANAGEMENT ---
+
+bool Spectator::Start(const char* hostName, int port, uint64_t match) {
+    Stop();
+
+    // One connection, same channels as a player
+    host = enet_host_create(NULL, 1, CHANNEL_COUNT, 0, 0);
+    if (!host) return false;
+
+    ENetAddress address;
+    enet_address_set_host(&address, hostName);
+    address.port = (enet_uint16)port;
+
+    matchId = match;
+    watching = false;
+    ended = false;
+    rounds = 0;
+    framesSimulated = 0;
+
+    // The connect data keeps the server from pairing us as a player
+    peer = enet_host_connect(host, &address, CHANNEL_COUNT, CONNECT_SPECTATOR);
+    if (!peer) {
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void Spectator::Stop() {
+    if (!host) return;
+    if (peer && isConnected) {
+        enet_peer_disconnect(peer, 0);
+        enet_host_flush(host);
+    }
+    enet_host_destroy(host);
+
+    host = nullptr;
+    peer = nullptr;
+    isConnected = false;
+}
+
+// --- MAIN UPDATE LOOP ---
+
+void Spectator::Update(uint32_t waitMs) {
+    if (!host) return;
+    ENetEvent event;
+
+    while (enet_host_service(host, &event, waitMs) > 0) {
+        waitMs = 0;
+
+        // 1. CONNECTED: subscribe to the match
+        if (event.type == ENET_EVENT_TYPE_CONNECT) {
+            isConnected = true;
+            NetMessage watch = WireProtocol::Make(PACKET_WATCH);
+            watch.token = matchId;
+            uint8_t buffer[WireProtocol::MAX_MESSAGE_SIZE];
+            size_t length = WireProtocol::Encode(watch, buffer);
+            enet_peer_send(peer, CHANNEL_CONTROL, enet_packet_create(buffer, length, ENET_PACKET_FLAG_RELIABLE));
+        }
+
+        // 2. STREAM RECEIVED
+        else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+            NetMessage message;
+            size_t pos = 0;
+            while (WireProtocol::DecodeNext(event.packet->data, event.packet->dataLength, pos, message)) {
+                HandleMessage(message);
+            }
+            enet_packet_destroy(event.packet);
+        }
+
+        // 3. DISCONNECTION
+        else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
+            isConnected = false;
+            ended = true;
+        }
+    }
+
+    // Both boards run every frame the stream covers
+    if (!watching) return;
+    for (int board = 0; board < 2; board++) {
+        uint32_t before = sessions[board].GetFrame();
+        sessions[board].Advance(boards[board], 0);
+        framesSimulated += sessions[board].GetFrame() - before;
+    }
+}
+
+void Spectator::HandleMessage(const NetMessage& message) {
+    switch (message.type) {
+        // New round: both boards start over (board 0 has the host's seed)
+        case PACKET_SEED:
+            boards[0].Reset(message.seedHost);
+            boards[1].Reset(message.seedClient);
+            sessions[0].Start();
+            sessions[1].Start();
+            watching = true;
+            rounds++;
+            break;
+
+        // Every frame of the window is final (idle unless listed)
+        case PACKET_WATCH_FRAMES: {
+            if (!watching) break;
+            RollbackSession& session = sessions[message.board];
+            for (int i = 0; i < message.inputCount; i++) session.AddInput(message.inputs[i].frame, message.inputs[i].input);
+            session.Confirm(message.endFrame);
+            break;
+        }
+
+        // The server's board as it is at the end of the stream so far
+        case PACKET_WATCH_STATE: {
+            if (!watching) break;
+            Simulation& board = boards[message.board];
+            Snapshot state;
+            board.Save(state);
+            if (!WireProtocol::DecodeState(message, state)) break;
+            if (sessions[message.board].Resync(message.frame)) board.Restore(state);
+            break;
+        }
+
+        case PACKET_QUIT:
+            ended = true;
+            break;
+
+        default: break;
+    }
+}
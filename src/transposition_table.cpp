@@ -0,0 +1,68 @@
+/**
+ * @file transposition_table.cpp
+ * @brief Implementation of the TranspositionTable class.
+ */
+
+#include "../include/transposition_table.hpp"
+#include <cstring>
+
+// Mixed into every check word so that an empty slot (both words zero) never matches a real key
+static const uint64_t EMPTY_CHECK = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t ToBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double FromBits(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+TranspositionTable::TranspositionTable(size_t entries) : probes(0), hits(0) {
+    size_t size = 1;
+    while (size < entries) size <<= 1;
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+    Clear();
+}
+
+bool TranspositionTable::Probe(uint64_t key, double& value) const {
+    const Slot& slot = slots[key & mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data ^ EMPTY_CHECK) != key) return false;
+    value = FromBits(data);
+    return true;
+}
+
+void TranspositionTable::Store(uint64_t key, double value) {
+    Slot& slot = slots[key & mask];
+    uint64_t data = ToBits(value);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data ^ EMPTY_CHECK, std::memory_order_relaxed);
+}
+
+void TranspositionTable::Clear() {
+    for (size_t i = 0; i <= mask; i++) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+void TranspositionTable::AddStats(uint64_t probeCount, uint64_t hitCount) {
+    probes.fetch_add(probeCount, std::memory_order_relaxed);
+    hits.fetch_add(hitCount, std::memory_order_relaxed);
+}
+
+void TranspositionTable::ResetStats() {
+    probes.store(0, std::memory_order_relaxed);
+    hits.store(0, std::memory_order_relaxed);
+}
+
+double TranspositionTable::GetHitRate() const {
+    uint64_t probeCount = GetProbes();
+    return probeCount ? (double)GetHits() / probeCount : 0.0;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file wire_protocol.cpp
+ * @brief Implementation of the WireProtocol class.
+ */
+
+#include "../include/wire_protocol.hpp"
+#include "../include/replay.hpp"
+
+static const uint8_t TYPE_MASK = 0x1F;
+static const int VERSION_SHIFT = 5;
+
+static_assert(PACKET_TYPE_COUNT <= TYPE_MASK + 1, "Packet types must fit in the header");
+static_assert(WireProtocol::VERSION < (1 << (8 - VERSION_SHIFT)), "The version must fit in the header");
+
+// --- LOCAL HELPER FUNCTIONS ---
+
+static size_t PutLittleEndian(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out[i] = (uint8_t)(value >> (8 * i));
+    return (size_t)bytes;
+}
+
+static size_t PutVarint(uint8_t* out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+// Frame range and inputs of PACKET_INPUT / PACKET_WATCH_FRAMES
+static size_t PutWindow(uint8_t* out, const NetMessage& message) {
+    size_t length = PutVarint(out, message.frame);
+    length += PutVarint(out + length, message.endFrame - message.frame);
+    out[length++] = (uint8_t)message.inputCount;
+    uint32_t next = message.frame;
+    for (int i = 0; i < message.inputCount; i++) {
+        length += PutVarint(out + length, message.inputs[i].frame - next);
+        out[length++] = ReplayWriter::EncodeInput(message.inputs[i].input);
+        next = message.inputs[i].frame + 1;
+    }
+    return length;
+}
+
+// Bounds-checked cursor: every read fails (and stays failed) past the end
+struct WireReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+    uint64_t LittleEndian(int bytes) {
+        if (!ok || size - pos < (size_t)bytes) { ok = false; return 0; }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) value |= (uint64_t)data[pos + i] << (8 * i);
+        pos += bytes;
+        return value;
+    }
+
+    uint32_t Varint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (!ok || pos >= size) break;
+            uint8_t byte = data[pos++];
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    // Frame range and inputs of PACKET_INPUT / PACKET_WATCH_FRAMES. False if malformed.
+    bool Window(NetMessage& message) {
+        message.frame = Varint();
+        message.endFrame = message.frame + Varint();
+        message.inputCount = (int)LittleEndian(1);
+        if (message.inputCount > MAX_WINDOW_INPUTS) return false;
+
+        // Listed frames are increasing and inside the window
+        uint32_t next = message.frame;
+        for (int i = 0; i < message.inputCount && ok; i++) {
+            uint32_t inputFrame = next + Varint();
+            uint8_t bits = (uint8_t)LittleEndian(1);
+            // No reset bit: it would reseed a finished board from the clock (rounds restart with PACKET_SEED)
+            if (bits & ~(REPLAY_LEFT | REPLAY_RIGHT | REPLAY_DOWN | REPLAY_ROTATE | REPLAY_HARD_DROP)) return false;
+            if (inputFrame < next || inputFrame >= message.endFrame) return false;
+            message.inputs[i].frame = inputFrame;
+            message.inputs[i].input = ReplayReader::DecodeInput(bits);
+            next = inputFrame + 1;
+        }
+        return ok;
+    }
+};
+
+// --- ENCODING ---
+
+size_t WireProtocol::Encode(const NetMessage& message, uint8_t* out) {
+    size_t length = 0;
+    out[length++] = (uint8_t)((message.type & TYPE_MASK) | (VERSION << VERSION_SHIFT));
+
+    switch (message.type) {
+        case PACKET_INPUT:
+            out[length++] = message.round;
+            length += PutVarint(out + length, message.ack);
+            length += PutWindow(out + length, message);
+            break;
+        case PACKET_WATCH_FRAMES:
+            out[length++] = message.board;
+            length += PutWindow(out + length, message);
+            break;
+        case PACKET_CHECKSUM:
+            out[length++] = message.round;
+            length += PutVarint(out + length, message.frame);
+            length += PutLittleEndian(out + length, message.checksum, 8);
+            break;
+        case PACKET_SEED:
+            out[length++] = message.round;
+            length += PutLittleEndian(out + length, message.seedHost, 4);
+            length += PutLittleEndian(out + length, message.seedClient, 4);
+            break;
+        case PACKET_RESTART_RES:
+        case PACKET_PAUSE_RES:
+        case PACKET_RESUME_RES:
+            out[length++] = message.accepted ? 1 : 0;
+            break;
+        case PACKET_REDIRECT:
+            length += PutLittleEndian(out + length, message.port, 2);
+            length += PutLittleEndian(out + length, message.token, 8);
+            break;
+        case PACKET_JOIN:
+        case PACKET_WATCH:
+            length += PutLittleEndian(out + length, message.token, 8);
+            break;
+        default: break;
+    }
+    return length;
+}
+
+void WireProtocol::EncodeState(uint32_t frame, const Snapshot& state, std::vector<uint8_t>& out) {
+    uint8_t header[MAX_MESSAGE_SIZE];
+    size_t length = 0;
+    header[length++] = (uint8_t)(PACKET_STATE | (VERSION << VERSION_SHIFT));
+    length += PutVarint(header + length, frame);
+
+    out.assign(header, header + length);
+    ReplayWriter::EncodeSnapshot(state, out);
+}
+
+void WireProtocol::AppendWatchState(uint8_t board, uint32_t frame, const Snapshot& state, std::vector<uint8_t>& out) {
+    uint8_t header[MAX_MESSAGE_SIZE];
+    size_t length = 0;
+    header[length++] = (uint8_t)(PACKET_WATCH_STATE | (VERSION << VERSION_SHIFT));
+    header[length++] = board;
+    length += PutVarint(header + length, frame);
+
+    out.insert(out.end(), header, header + length);
+    ReplayWriter::EncodeSnapshot(state, out);
+}
+
+// --- DECODING ---
+
+bool WireProtocol::Decode(const uint8_t* data, size_t size, NetMessage& message) {
+    size_t pos = 0;
+    return DecodeNext(data, size, pos, message) && pos == size;
+}
+
+bool WireProtocol::DecodeNext(const uint8_t* data, size_t size, size_t& pos, NetMessage& message) {
+    if (pos >= size || (data[pos] >> VERSION_SHIFT) != VERSION) return false;
+    uint8_t type = data[pos] & TYPE_MASK;
+    if (type >= PACKET_TYPE_COUNT) return false;
+
+    message = Make((PacketType)type);
+    WireReader reader = { data, size, pos + 1, true };
+
+    switch (message.type) {
+        case PACKET_INPUT:
+            message.round = (uint8_t)reader.LittleEndian(1);
+            message.ack = reader.Varint();
+            if (!reader.Window(message)) return false;
+            break;
+        case PACKET_WATCH_FRAMES:
+            message.board = (uint8_t)reader.LittleEndian(1);
+            if (message.board > 1 || !reader.Window(message)) return false;
+            break;
+        case PACKET_CHECKSUM:
+            message.round = (uint8_t)reader.LittleEndian(1);
+            message.frame = reader.Varint();
+            message.checksum = reader.LittleEndian(8);
+            break;
+        case PACKET_WATCH_STATE:
+            message.board = (uint8_t)reader.LittleEndian(1);
+            if (message.board > 1) return false;
+            // fall through
+        case PACKET_STATE: {
+            message.frame = reader.Varint();
+            if (!reader.ok) return false;
+
+            // Validated here, decoded on demand (DecodeState)
+            size_t body = reader.pos;
+            uint64_t tick;
+            if (!ReplayReader::DecodeSnapshot(data, size, reader.pos, nullptr, tick)) return false;
+            message.state = data + body;
+            message.stateSize = reader.pos - body;
+            break;
+        }
+        case PACKET_SEED:
+            message.round = (uint8_t)reader.LittleEndian(1);
+            message.seedHost = (uint32_t)reader.LittleEndian(4);
+            message.seedClient = (uint32_t)reader.LittleEndian(4);
+            break;
+        case PACKET_RESTART_RES:
+        case PACKET_PAUSE_RES:
+        case PACKET_RESUME_RES: {
+            uint64_t accepted = reader.LittleEndian(1);
+            if (accepted > 1) return false;
+            message.accepted = accepted == 1;
+            break;
+        }
+        case PACKET_REDIRECT:
+            message.port = (uint16_t)reader.LittleEndian(2);
+            message.token = reader.LittleEndian(8);
+            break;
+        case PACKET_JOIN:
+        case PACKET_WATCH:
+            message.token = reader.LittleEndian(8);
+            break;
+        default: break;
+    }
+    if (!reader.ok) return false;
+    pos = reader.pos;
+    return true;
+}
+
+bool WireProtocol::DecodeState(const NetMessage& message, Snapshot& state) {
+    if ((message.type != PACKET_STATE && message.type != PACKET_WATCH_STATE) || !message.state) return false;
+    size_t pos = 0;
+    uint64_t tick;
+    return ReplayReader::DecodeSnapshot(message.state, message.stateSize, pos, &state, tick);
+}
+
+// --- BUILDERS ---
+
+NetMessage WireProtocol::Make(PacketType type) {
+    NetMessage message = {};
+    message.type = type;
+    return message;
+}
+
+NetMessage WireProtocol::MakeChecksum(uint8_t round, uint32_t frame, uint64_t checksum) {
+    NetMessage message = Make(PACKET_CHECKSUM);
+    message.round = round;
+    message.frame = frame;
+    message.checksum = checksum;
+    return message;
+}
+
+NetMessage WireProtocol::MakeSeed(uint8_t round, uint32_t seedHost, uint32_t seedClient) {
+    NetMessage message = Make(PACKET_SEED);
+    message.round = round;
+    message.seedHost = seedHost;
+    message.seedClient = seedClient;
+    return message;
+}
+
+NetMessage WireProtocol::MakeResponse(PacketType type, bool accepted) {
+    NetMessage message = Make(type);
+    message.accepted = accepted;
+    return message;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file zobrist.cpp
+ * @brief Implementation of the Zobrist class.
+ */
+
+#include "../include/zobrist.hpp"
+#include "../include/grid.hpp"
+
+// Piece origins handled by Piece (same ranges as PlacementEnumerator)
+static const int PIECE_ROW_MIN = -3, PIECE_ROW_SPAN = 24;
+static const int PIECE_COLUMN_MIN = -3, PIECE_COLUMN_SPAN = 16;
+
+// Rows are split into two 5-column halves, each looked up in a 32-entry table
+static const int HALF_COLUMNS = 5;
+
+struct ZobristKeys {
+    uint64_t cells[Grid::NUM_ROWS][Grid::NUM_COLUMNS];
+    uint64_t rowHalves[Grid::NUM_ROWS][2][1 << HALF_COLUMNS];
+    uint64_t pieces[8][4];
+    uint64_t pieceRows[PIECE_ROW_SPAN];
+    uint64_t pieceColumns[PIECE_COLUMN_SPAN];
+    uint64_t next[8];
+
+    ZobristKeys() {
+        // SplitMix64 from a fixed seed: the same keys on every run
+        uint64_t state = 0x54455452495321ULL;
+        auto random = [&state]() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+
+        for (int row = 0; row < Grid::NUM_ROWS; row++) {
+            for (int column = 0; column < Grid::NUM_COLUMNS; column++) cells[row][column] = random();
+            for (int half = 0; half < 2; half++) {
+                for (int bits = 0; bits < (1 << HALF_COLUMNS); bits++) {
+                    uint64_t key = 0;
+                    for (int c = 0; c < HALF_COLUMNS; c++) {
+                        if (bits & (1 << c)) key ^= cells[row][half * HALF_COLUMNS + c];
+                    }
+                    rowHalves[row][half][bits] = key;
+                }
+            }
+        }
+        for (int id = 0; id < 8; id++) {
+            for (int rotation = 0; rotation < 4; rotation++) pieces[id][rotation] = random();
+            next[id] = random();
+        }
+        for (int row = 0; row < PIECE_ROW_SPAN; row++) pieceRows[row] = random();
+        for (int column = 0; column < PIECE_COLUMN_SPAN; column++) pieceColumns[column] = random();
+    }
+};
+
+static const ZobristKeys keys;
+
+uint64_t Zobrist::Cell(int row, int column) {
+    return keys.cells[row][column];
+}
+
+uint64_t Zobrist::Row(int row, uint16_t mask) {
+    uint32_t cells = (uint32_t)mask >> Grid::WALL_BITS;
+    return keys.rowHalves[row][0][cells & 0x1F] ^ keys.rowHalves[row][1][(cells >> HALF_COLUMNS) & 0x1F];
+}
+
+uint64_t Zobrist::Rows(const uint16_t* rows, int count) {
+    uint64_t hash = 0;
+    for (int row = 0; row < count; row++) hash ^= Row(row, rows[row]);
+    return hash;
+}
+
+uint64_t Zobrist::Piece(int id, int rotation, int row, int column) {
+    return keys.pieces[id & 7][rotation & 3] ^
+           keys.pieceRows[(uint32_t)(row - PIECE_ROW_MIN) % PIECE_ROW_SPAN] ^
+           keys.pieceColumns[(column - PIECE_COLUMN_MIN) & (PIECE_COLUMN_SPAN - 1)];
+}
+
+uint64_t Zobrist::Next(int id) {
+    return keys.next[id & 7];
+}
+
+uint64_t Zobrist::Mix(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file alloc_check.cpp
+ * @brief Checks that moving, rotating, computing the ghost row and hard dropping
+ * a piece never touch the heap. Replaces the global operator new / delete with
+ * counting versions and runs each operation on games in progress. Prints the
+ * allocations seen per operation and exits with 1 if there was any.
+ *
+ * Usage: alloc_check [iterations]
+ */
+
+#include "../include/sim_runner.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// --- COUNTING ALLOCATOR ---
+
+static bool counting = false;
+static unsigned long long allocations = 0;
+static unsigned long long deallocations = 0;
+
+void* operator new(std::size_t size) {
+    if (counting) allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    if (counting) allocations++;
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    if (counting && p) deallocations++;
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+// --- PROBE ---
+
+// Exposes the piece operations Simulation keeps to itself
+class Probe : public Simulation {
+public:
+    using Simulation::GetGhostRow;
+    using Simulation::MoveBlockLeft;
+    using Simulation::MoveBlockRight;
+    using Simulation::RotateBlock;
+};
+
+// Runs 'op' on a game in progress 'iterations' times and reports the heap calls it made.
+// Setting up the games (Reset, random ticks) is not counted. Returns true if nothing allocated.
+template <typename Op>
+static bool Check(const char* name, int iterations, Op op) {
+    Probe game;
+    uint32_t seed = 1;
+    uint64_t policyState = 1;
+    unsigned long long allocated = 0, freed = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        if (game.gameOver || i % 500 == 0) {
+            game.Reset((int)seed++);
+            for (int t = 0; t < 200 && !game.gameOver; t++) game.Tick(SimRunner::RandomPolicy(game, policyState));
+            if (game.gameOver) continue;
+        }
+
+        allocations = deallocations = 0;
+        counting = true;
+        op(game);
+        counting = false;
+        allocated += allocations;
+        freed += deallocations;
+    }
+
+    printf("%-14s %10d calls | %llu allocations, %llu frees\n", name, iterations, allocated, freed);
+    return allocated == 0 && freed == 0;
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    bool clean = true;
+    clean &= Check("MoveBlockLeft", iterations, [](Probe& g) { g.MoveBlockLeft(); });
+    clean &= Check("MoveBlockRight", iterations, [](Probe& g) { g.MoveBlockRight(); });
+    clean &= Check("MoveBlockDown", iterations, [](Probe& g) { g.MoveBlockDown(); });
+    clean &= Check("RotateBlock", iterations, [](Probe& g) { g.RotateBlock(); });
+    clean &= Check("GetGhostRow", iterations, [](Probe& g) { g.RotateBlock(); volatile int row = g.GetGhostRow(); (void)row; });
+    clean &= Check("HardDrop", iterations, [](Probe& g) { g.HardDrop(); });
+
+    printf("%s\n", clean ? "NO ALLOCATIONS" : "ALLOCATIONS FOUND");
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file batch_bench.cpp
+ * @brief Steps a large BatchSimulation with random actions and prints its
+ * throughput in board-steps per second. A few boards are shadowed by plain
+ * Simulation objects fed the same seeds and actions (HandleInput followed by one
+ * gravity row, as StepBatch does) and compared after every step, so the batched
+ * rules are checked against the real ones. Exits with 1 on any difference.
+ *
+ * Usage: batch_bench [boards] [steps] [checkedBoards]
+ */
+
+#include "../include/batch_simulation.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// The single-board input matching a batch action
+static InputState ToInput(BatchAction action) {
+    InputState input = {};
+    input.left = action == ACTION_LEFT;
+    input.right = action == ACTION_RIGHT;
+    input.rotate = action == ACTION_ROTATE;
+    input.down = action == ACTION_SOFT_DROP;
+    input.hardDrop = action == ACTION_HARD_DROP;
+    return input;
+}
+
+// True if board 'board' of the batch is in the same state as 'game'
+static bool SameBoard(const BatchSimulation& batch, int board, const Simulation& game) {
+    return memcmp(batch.GetRows(board), game.GetGrid().GetRows(), Grid::NUM_ROWS * sizeof(uint16_t)) == 0 &&
+           batch.GetPiece(board) == game.GetCurrentBlock().id && batch.GetNextPiece(board) == game.GetNextBlock().id &&
+           batch.GetScore(board) == game.score && batch.GetLevel(board) == game.level &&
+           batch.GetLinesCleared(board) == game.totalLinesCleared && batch.IsGameOver(board) == game.gameOver;
+}
+
+int main(int argc, char** argv) {
+    int numBoards = argc > 1 ? atoi(argv[1]) : 16384;
+    int steps = argc > 2 ? atoi(argv[2]) : 2000;
+    int checked = argc > 3 ? atoi(argv[3]) : 16;
+    if (checked > numBoards) checked = numBoards;
+
+    const uint32_t SEED = 1;
+    BatchSimulation batch(numBoards, SEED);
+    std::vector<BatchAction> actions(numBoards);
+
+    // Shadow games for the first 'checked' boards (board i is seeded with SEED + i)
+    std::vector<Simulation> shadows(checked);
+    std::vector<uint32_t> seeds(numBoards);
+    for (int i = 0; i < numBoards; i++) seeds[i] = SEED + i;
+    for (int i = 0; i < checked; i++) shadows[i].Reset((int)seeds[i]);
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    uint32_t nextSeed = SEED + numBoards;
+    uint64_t games = 0, comparisons = 0, mismatches = 0;
+
+    for (int step = 0; step < steps; step++) {
+        for (int i = 0; i < numBoards; i++) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            actions[i] = (BatchAction)((rng >> 32) % 6);
+        }
+
+        batch.StepBatch(actions.data());
+
+        for (int i = 0; i < checked; i++) {
+            shadows[i].HandleInput(ToInput(actions[i]));
+            shadows[i].MoveBlockDown();
+            comparisons++;
+            if (!SameBoard(batch, i, shadows[i])) {
+                if (mismatches++ == 0) fprintf(stderr, "board %d (seed %u) differs at step %d\n", i, seeds[i], step);
+            }
+        }
+
+        // Finished boards start a new game with a fresh seed (not timed)
+        for (int i = 0; i < numBoards; i++) {
+            if (!batch.IsGameOver(i)) continue;
+            games++;
+            seeds[i] = nextSeed++;
+            batch.ResetBoard(i, seeds[i]);
+            if (i < checked) shadows[i].Reset((int)seeds[i]);
+        }
+    }
+
+    printf("%d boards x %d steps: %.1f M board-steps/s | %llu games finished\n", numBoards, steps,
+           batch.GetStepsPerSecond() / 1e6, (unsigned long long)games);
+    printf("cross-check against Simulation: %d boards, %llu comparisons, %llu mismatches\n", checked,
+           (unsigned long long)comparisons, (unsigned long long)mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file bot_play.cpp
+ * @brief Plays headless games with the AIPlayer and reports the results and the
+ * decision latency (each decision must fit well inside a 16 ms frame) and the
+ * hit rate of its evaluation cache.
+ *
+ * Usage: bot_play [games] [lookahead] [beamWidth] [threads] [maxPieces]
+ */
+
+#include "../include/ai_player.hpp"
+#include "../include/sim_runner.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    int games = argc > 1 ? atoi(argv[1]) : 10;
+    int lookahead = argc > 2 ? atoi(argv[2]) : 2;
+    int beamWidth = argc > 3 ? atoi(argv[3]) : 32;
+    int threads = argc > 4 ? atoi(argv[4]) : 0;
+    int maxPieces = argc > 5 ? atoi(argv[5]) : 1000;
+
+    AIPlayer bot(lookahead, beamWidth, threads);
+    Distribution lines, score, decisionMicros;
+
+    for (int g = 0; g < games; g++) {
+        Simulation game;
+        game.Reset(g + 1);
+        bot.Reset();
+
+        // Pieces are counted by decisions (one per spawned piece)
+        int pieces = 0;
+        double lastDecision = -1;
+        while (!game.gameOver && pieces < maxPieces) {
+            game.Tick(bot.GetInput(game));
+            if (bot.GetLastDecisionMs() != lastDecision) {
+                lastDecision = bot.GetLastDecisionMs();
+                decisionMicros.Add((int)(lastDecision * 1000));
+                pieces++;
+            }
+        }
+        lines.Add(game.totalLinesCleared);
+        score.Add(game.score);
+        printf("game %d: %d lines, score %d, %s\n", g + 1, game.totalLinesCleared, game.score,
+               game.gameOver ? "topped out" : "piece limit");
+    }
+
+    printf("lines    mean %8.1f | p50 %7d | max %7d\n", lines.Mean(), lines.Percentile(0.5), lines.Max());
+    printf("score    mean %8.1f | p50 %7d | max %7d\n", score.Mean(), score.Percentile(0.5), score.Max());
+    printf("decision mean %8.1f us | p50 %5d us | p99 %5d us | max %5d us\n", decisionMicros.Mean(),
+           decisionMicros.Percentile(0.5), decisionMicros.Percentile(0.99), decisionMicros.Max());
+    printf("eval cache %llu probes | hit rate %.1f%%\n", (unsigned long long)bot.GetEvalCache().GetProbes(),
+           bot.GetEvalCache().GetHitRate() * 100.0);
+    return 0;
+}
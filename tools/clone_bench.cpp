@@ -0,0 +1,48 @@
+/**
+ * @file clone_bench.cpp
+ * @brief Measures the cost of cloning a game: Simulation::Save / Restore into a
+ * Snapshot, plain Snapshot copies and whole Simulation copies.
+ *
+ * Usage: clone_bench [iterations]
+ */
+
+#include "../include/sim_runner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Runs 'op' for every iteration and prints the cost per call
+template <typename Op>
+static void Measure(const char* name, int iterations, Op op) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) op(i);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-18s %8.2f ns/op  (%.1f M/s)\n", name, seconds * 1e9 / iterations, iterations / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 10000000;
+
+    // A game in progress, so the board is not trivially empty
+    Simulation game;
+    game.Reset(1);
+    uint64_t policyState = 1;
+    for (int t = 0; t < 300 && !game.gameOver; t++) game.Tick(SimRunner::RandomPolicy(game, policyState));
+
+    // A small ring of destinations keeps the copies from being optimized into one
+    const int RING = 64;
+    std::vector<Snapshot> snapshots(RING);
+    std::vector<Simulation> copies(RING);
+    volatile int sink = 0;
+
+    printf("sizeof(Snapshot) = %zu bytes, sizeof(Simulation) = %zu bytes\n", sizeof(Snapshot), sizeof(Simulation));
+
+    Measure("Save", iterations, [&](int i) { game.Save(snapshots[i & (RING - 1)]); sink = snapshots[i & (RING - 1)].score; });
+    Measure("Restore", iterations, [&](int i) { copies[i & (RING - 1)].Restore(snapshots[i & (RING - 1)]); sink = copies[i & (RING - 1)].score; });
+    Measure("Snapshot copy", iterations, [&](int i) { snapshots[(i + 1) & (RING - 1)] = snapshots[i & (RING - 1)]; sink = snapshots[i & (RING - 1)].score; });
+    Measure("Simulation copy", iterations, [&](int i) { copies[i & (RING - 1)] = game; sink = copies[i & (RING - 1)].score; });
+
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file corpus.cpp
+ * @brief Replay corpus tool: archives bot games into a memory-mapped corpus and
+ * queries it, re-simulating the selected games to check their recorded results.
+ *
+ * Usage: corpus build <file> [games]
+ *        corpus query <file> [minLevel] [minScore]
+ */
+
+#include "../include/replay_corpus.hpp"
+#include "../include/sim_runner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static int Build(const char* path, int games) {
+    ReplayCorpusWriter corpus;
+    if (!corpus.Open(path)) { fprintf(stderr, "Cannot write %s\n", path); return 1; }
+
+    Simulation game;
+    ReplayWriter writer;
+    for (int i = 0; i < games; i++) {
+        uint32_t seed = (uint32_t)(i + 1);
+        uint64_t policyState = seed;
+        game.Reset((int)seed);
+        writer.Begin(game);
+        for (int t = 0; t < 60 * 60 * 10 && !game.gameOver; t++) {
+            game.Tick(SimRunner::RandomPolicy(game, policyState));
+        }
+        writer.Finish();
+        corpus.Add(writer.GetData().data(), writer.GetData().size());
+    }
+
+    printf("%zu games written\n", corpus.GetCount());
+    return corpus.Close() ? 0 : 1;
+}
+
+static int Query(const char* path, int minLevel, int minScore) {
+    ReplayCorpus corpus;
+    if (!corpus.Open(path)) { fprintf(stderr, "Not a replay corpus: %s\n", path); return 1; }
+
+    CorpusQuery query;
+    query.minLevel = minLevel;
+    query.minScore = minScore;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint32_t> matches = corpus.Query(query);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%zu of %zu games match (index scan %.3f ms)\n", matches.size(), corpus.GetCount(), seconds * 1000);
+
+    // Re-simulate the matches and compare with the index
+    int mismatches = 0;
+    Simulation game;
+    for (uint32_t index : matches) {
+        ReplayReader reader;
+        if (!corpus.OpenReplay(index, reader) || !reader.Start(game)) { mismatches++; continue; }
+        reader.PlayToEnd(game);
+        const CorpusEntry& e = corpus.GetEntry(index);
+        if ((uint32_t)game.score != e.score || game.level != e.level || (uint32_t)game.totalLinesCleared != e.linesCleared) {
+            mismatches++;
+        }
+    }
+    printf("re-simulated %zu games, %d mismatches\n", matches.size(), mismatches);
+    return mismatches ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "build") == 0) {
+        return Build(argv[2], argc > 3 ? atoi(argv[3]) : 1000);
+    }
+    if (argc >= 3 && strcmp(argv[1], "query") == 0) {
+        return Query(argv[2], argc > 3 ? atoi(argv[3]) : 0, argc > 4 ? atoi(argv[4]) : 0);
+    }
+    fprintf(stderr, "Usage: corpus build <file> [games]\n"
+                    "       corpus query <file> [minLevel] [minScore]\n");
+    return 1;
+}
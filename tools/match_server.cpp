@@ -0,0 +1,88 @@
+/**
+ * @file match_server.cpp
+ * @brief Headless dedicated match server. Players join with "Join Game" and are
+ * paired in connection order. Stops on Ctrl+C.
+ *
+ * Usage: match_server [port] [maxClients] [equal|random] [shards] [sendRate] [botWait]
+ *   shards = 0 (default): one MatchServer thread serves every match on 'port'.
+ *   shards > 0: ShardedServer, a lobby on 'port' plus 'shards' worker threads on the
+ *   following ports (maxClients per shard). Needs clients that follow PACKET_REDIRECT.
+ *   sendRate: network ticks per second, one packet per player each (default 30).
+ *   botWait: seconds a lone player waits before playing a server bot (default 10, negative: never).
+ * Spectators (see tools/spectate.cpp) connect to the port of the server or shard hosting the match.
+ */
+
+#include "../include/match_server.hpp"
+#include "../include/sharded_server.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static volatile std::sig_atomic_t running = 1;
+
+static void OnSignal(int) {
+    running = 0;
+}
+
+int main(int argc, char** argv) {
+    int port = argc > 1 ? atoi(argv[1]) : 1234;
+    int maxClients = argc > 2 ? atoi(argv[2]) : 256;
+    bool sameSeeds = !(argc > 3 && strcmp(argv[3], "random") == 0);
+    int numShards = argc > 4 ? atoi(argv[4]) : 0;
+    int sendRate = argc > 5 ? atoi(argv[5]) : 30;
+    double botWait = argc > 6 ? atof(argv[6]) : 10;
+
+    MatchServer server;
+    ShardedServer sharded;
+    server.useSameSeeds = sameSeeds;
+    sharded.useSameSeeds = sameSeeds;
+    server.SetSendRate(sendRate);
+    sharded.sendRate = sendRate;
+    server.botWaitSeconds = botWait;
+    sharded.botWaitSeconds = botWait;
+
+    bool started = numShards > 0 ? sharded.Start(port, numShards, maxClients) : server.Start(port, maxClients);
+    if (!started) {
+        fprintf(stderr, "Could not open port %d\n", port);
+        return 1;
+    }
+    if (numShards > 0) printf("Lobby on port %d, %d shards on ports %d-%d (%d clients each, %s seeds)\n", port,
+                              numShards, port + 1, port + numShards, maxClients, sameSeeds ? "equal" : "random");
+    else printf("Serving on port %d (%d clients, %s seeds)\n", port, maxClients, sameSeeds ? "equal" : "random");
+
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    // Waits up to 1 ms for network events per pass, so relayed inputs stay within a millisecond of their arrival
+    auto last = std::chrono::steady_clock::now();
+    auto lastReport = last;
+    uint64_t lastFrames = 0, lastPackets = 0;
+    while (running) {
+        auto now = std::chrono::steady_clock::now();
+        if (numShards > 0) sharded.Update(1);
+        else server.Update(std::chrono::duration<double>(now - last).count(), 1);
+        last = now;
+
+        if (now - lastReport >= std::chrono::seconds(10)) {
+            double seconds = std::chrono::duration<double>(now - lastReport).count();
+            size_t matches = numShards > 0 ? sharded.GetMatchCount() : server.GetMatchCount();
+            bool waiting = numShards > 0 ? sharded.HasWaitingPlayer() : server.HasWaitingPlayer();
+            uint64_t frames = numShards > 0 ? sharded.GetFramesSimulated() : server.GetFramesSimulated();
+            uint64_t packets = numShards > 0 ? sharded.GetPacketsSent() : server.GetBatcher().GetPacketsSent();
+            size_t spectators = numShards > 0 ? sharded.GetSpectatorCount() : server.GetSpectatorCount();
+            printf("%zu matches | %s | %zu spectators | %.0f frames/s | %.0f packets/s\n", matches,
+                   waiting ? "1 waiting" : "0 waiting", spectators, (frames - lastFrames) / seconds,
+                   (packets - lastPackets) / seconds);
+            lastFrames = frames;
+            lastPackets = packets;
+            lastReport = now;
+        }
+    }
+
+    sharded.Stop();
+    server.Stop();
+    printf("Server stopped\n");
+    return 0;
+}
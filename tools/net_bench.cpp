@@ -0,0 +1,179 @@
+/**
+ * @file net_bench.cpp
+ * @brief Online play over a bad network, on one machine and offline: two
+ * headless NetworkManager endpoints (a host and a client, each board played by
+ * a bot) in one process, the client connected through a NetworkShim that
+ * impairs the loopback path. Runs in real time and reports how long an input
+ * takes to reach the other side's copy of the board (from the press to the
+ * frame being confirmed there), the traffic on the wire, and whether every
+ * remote copy stayed identical to the real board. Exits with 1 if they did not.
+ *
+ * Usage: net_bench [seconds] [delayMs] [jitterMs] [loss%] [duplicate%] [reorder%] [sendRate] [seed]
+ *   The link profile applies to both directions (delay 50, jitter 10, loss 2%, duplicate 1%,
+ *   reorder 2% by default). Uses UDP ports 7777 (host) and 7778 (shim) on 127.0.0.1.
+ */
+
+#include "../include/NetworkManager.hpp"
+#include "../include/ai_player.hpp"
+#include "../include/network_shim.hpp"
+#include "../include/sim_runner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <thread>
+#include <unordered_map>
+
+static const int HOST_PORT = 7777;
+static const int SHIM_PORT = 7778;
+
+// A local frame with a button pressed, waiting to be confirmed on the other side
+struct Press {
+    uint32_t frame;
+    double timeMs;
+};
+
+// One side of the match: network endpoint, both boards, and the bot playing the local one
+struct Endpoint {
+    NetworkManager net;
+    Simulation local, remote;
+    bool paused = false;
+    float countdown = 0;
+    bool started = false;                            // The seeds arrived (they start the countdown)
+    AIPlayer bot{ 1, 8, 1 };
+    std::unordered_map<uint64_t, uint64_t> history;  // State hash of the local board per tick
+    std::deque<Press> presses;
+    Distribution latency;                            // Milliseconds, press to remote confirmation
+};
+
+// Presses of 'from' that 'to' has confirmed by now
+static void CollectLatency(Endpoint& from, const Endpoint& to, double nowMs) {
+    uint32_t confirmed = to.net.GetRollback().GetConfirmedFrame();
+    while (!from.presses.empty() && from.presses.front().frame < confirmed) {
+        from.latency.Add((int)(nowMs - from.presses.front().timeMs + 0.5));
+        from.presses.pop_front();
+    }
+}
+
+// Compares the copy 'to' keeps of the board of 'from' with the real one, once no rollback can change it
+// (boards are only comparable once both sides have the seeds)
+static void CheckSync(const Endpoint& from, const Endpoint& to, uint64_t& checks, uint64_t& mismatches) {
+    if (!to.started) return;
+    const RollbackSession& session = to.net.GetRollback();
+    if (session.GetFrame() > session.GetConfirmedFrame()) return;
+    auto real = from.history.find(to.remote.GetTick());
+    if (real == from.history.end()) return;
+    checks++;
+    if (real->second != to.remote.GetStateHash()) mismatches++;
+}
+
+static void PrintLatency(const char* name, const Endpoint& endpoint) {
+    const Distribution& d = endpoint.latency;
+    printf("  %-15s %6llu inputs | p50 %4d | p90 %4d | p99 %4d | max %4d ms | %zu still in flight\n", name,
+           (unsigned long long)d.Count(), d.Percentile(0.5), d.Percentile(0.9), d.Percentile(0.99), d.Max(),
+           endpoint.presses.size());
+}
+
+static void PrintLink(const char* name, const LinkStats& stats, double seconds) {
+    printf("  %-15s %6.1f packets/s %7.0f bytes/s | dropped %llu, duplicated %llu, reordered %llu\n", name,
+           stats.packets / seconds, stats.bytes / seconds, (unsigned long long)stats.dropped,
+           (unsigned long long)stats.duplicated, (unsigned long long)stats.reordered);
+}
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 60;
+    LinkProfile profile;
+    profile.delayMs = argc > 2 ? atof(argv[2]) : 50;
+    profile.jitterMs = argc > 3 ? atof(argv[3]) : 10;
+    profile.loss = (argc > 4 ? atof(argv[4]) : 2) / 100.0;
+    profile.duplicate = (argc > 5 ? atof(argv[5]) : 1) / 100.0;
+    profile.reorder = (argc > 6 ? atof(argv[6]) : 2) / 100.0;
+    int sendRate = argc > 7 ? atoi(argv[7]) : 30;
+    uint32_t seed = argc > 8 ? (uint32_t)atoi(argv[8]) : 1;
+
+    Endpoint host, client;
+    NetworkShim shim;
+    shim.GetProfile(LINK_TO_SERVER) = profile;
+    shim.GetProfile(LINK_TO_CLIENT) = profile;
+    if (!host.net.StartServer(HOST_PORT) || !shim.Start(SHIM_PORT, "127.0.0.1", HOST_PORT, seed) ||
+        !client.net.StartClient("127.0.0.1", SHIM_PORT)) {
+        fprintf(stderr, "Could not open UDP ports %d-%d on 127.0.0.1\n", HOST_PORT, SHIM_PORT);
+        return 1;
+    }
+    host.net.SetSendRate(sendRate);
+    client.net.SetSendRate(sendRate);
+    host.bot.ticksPerMove = 3;
+    client.bot.ticksPerMove = 3;
+
+    printf("link each way: delay %.0f ms, jitter %.0f ms, loss %.1f%%, duplicate %.1f%%, reorder %.1f%% | %d network ticks/s | %d s\n",
+           profile.delayMs, profile.jitterMs, profile.loss * 100, profile.duplicate * 100, profile.reorder * 100,
+           sendRate, seconds);
+
+    // Frames at 60 Hz of real time, the shim pumped in between
+    const double DT = 1.0 / 60.0;
+    const int frames = seconds * 60;
+    uint64_t checks = 0, mismatches = 0;
+    auto start = std::chrono::steady_clock::now();
+    Endpoint* endpoints[2] = { &host, &client };
+
+    for (int frame = 0; frame < frames;) {
+        shim.Update();
+        double nowMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (nowMs < frame * DT * 1000.0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+            continue;
+        }
+
+        for (Endpoint* e : endpoints) {
+            e->net.Update(e->local, e->remote, e->paused, e->countdown);
+            if (e->countdown > 0) e->started = true;
+        }
+        CollectLatency(host, client, nowMs);
+        CollectLatency(client, host, nowMs);
+
+        for (Endpoint* e : endpoints) {
+            if (e->countdown > 0) e->countdown -= (float)DT;
+            bool stopped = e->countdown > 0;
+            InputState input = stopped ? InputState{} : e->bot.GetInput(e->local);
+            uint32_t before = (uint32_t)e->local.GetTick();
+            bool pressed = input.left || input.right || input.down || input.rotate || input.hardDrop;
+            if (e->net.StepLocal(e->local, input, DT, stopped) > 0 && pressed && !e->local.gameOver) {
+                e->presses.push_back({ before, nowMs });
+            }
+            if (e->started) e->history[e->local.GetTick()] = e->local.GetStateHash();
+            e->net.Flush(DT);
+        }
+
+        CheckSync(host, client, checks, mismatches);
+        CheckSync(client, host, checks, mismatches);
+        frame++;
+    }
+
+    printf("input latency (press to the other side's board):\n");
+    PrintLatency("host -> client", host);
+    PrintLatency("client -> host", client);
+
+    printf("wire (UDP payload, ENet headers included):\n");
+    PrintLink("client -> host", shim.GetStats(LINK_TO_SERVER), seconds);
+    PrintLink("host -> client", shim.GetStats(LINK_TO_CLIENT), seconds);
+    printf("  messages: host %.0f bytes/s, client %.0f bytes/s before ENet\n",
+           host.net.GetBatcher().GetBytesSent() / (double)seconds, client.net.GetBatcher().GetBytesSent() / (double)seconds);
+
+    const RollbackStats& h = host.net.GetRollback().GetStats();
+    const RollbackStats& c = client.net.GetRollback().GetStats();
+    printf("sync: %llu equal-frame checks, %llu mismatches | checksums verified %llu, desyncs %llu | rollbacks %llu, deepest %u frames\n",
+           (unsigned long long)checks, (unsigned long long)mismatches,
+           (unsigned long long)(h.checksumsVerified + c.checksumsVerified), (unsigned long long)(h.desyncs + c.desyncs),
+           (unsigned long long)(h.rollbacks + c.rollbacks), h.maxDepth > c.maxDepth ? h.maxDepth : c.maxDepth);
+    printf("boards: host %llu ticks, score %d%s | client %llu ticks, score %d%s\n",
+           (unsigned long long)host.local.GetTick(), host.local.score, host.local.gameOver ? " (topped out)" : "",
+           (unsigned long long)client.local.GetTick(), client.local.score, client.local.gameOver ? " (topped out)" : "");
+
+    bool inSync = checks > 0 && mismatches == 0 && h.desyncs + c.desyncs == 0;
+    printf("%s\n", inSync ? "IN SYNC" : (checks == 0 ? "NOT CONNECTED" : "OUT OF SYNC"));
+
+    client.net.Stop();
+    host.net.Stop();
+    shim.Stop();
+    return inSync ? 0 : 1;
+}
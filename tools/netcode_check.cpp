@@ -0,0 +1,379 @@
+/**
+ * @file netcode_check.cpp
+ * @brief Deterministic offline check of the online netcode (rollback, desync
+ * detection and resync, redundant input windows). Two NetworkManagers, a host
+ * and a client with each board played by a bot, run in one process over an
+ * in-memory ENet link in simulated time: a fixed one-way delay, unreliable
+ * packets dropped at the loss rate, reliable ones resent in order after a
+ * timeout. Every confirmed copy of a remote board is compared with the real
+ * board at the same frame (a copy is compared only while fully confirmed, which
+ * past the rollback window is rare; the sampled checksums cover those frames).
+ * Scenarios cover delays up to 45 frames, heavy loss, a board corrupted on
+ * purpose (must be detected and resynced) and a restart.
+ * Prints one line per scenario and exits with 1 if any failed.
+ *
+ * The tool provides the ENet functions NetworkManager calls itself: link it
+ * WITHOUT the ENet library (NetworkManager, PacketBatcher, InputChannel,
+ * RollbackSession, WireProtocol, AIPlayer and the simulation core).
+ *
+ * Usage: netcode_check [seconds per scenario] [seed]
+ */
+
+#include <enet/enet.h>
+#include "../include/NetworkManager.hpp"
+#include "../include/ai_player.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// --- IN-MEMORY ENET ---
+
+namespace {
+
+struct Delivery {
+    uint32_t time;
+    ENetEvent event;
+};
+
+struct Link {
+    uint32_t now = 0;                          // Milliseconds of simulated time
+    uint32_t delayMs = 0;
+    double loss = 0;
+    std::mt19937 rng;
+    std::vector<ENetHost*> hosts;
+    std::map<ENetHost*, std::deque<Delivery>> queues;           // Events of each host, by delivery time
+    std::map<ENetPeer*, std::pair<ENetHost*, ENetPeer*>> routes; // Local peer -> remote host and peer
+    std::map<ENetHost*, uint32_t> lastReliable;                  // Reliable packets arrive in order
+    std::multimap<uint32_t, ENetPacket*> inFlight;               // Sent packets, referenced until delivered
+    uint64_t packets = 0, lost = 0;
+};
+
+Link wire;
+
+void Push(ENetHost* host, uint32_t time, const ENetEvent& event) {
+    std::deque<Delivery>& queue = wire.queues[host];
+    auto it = queue.end();
+    while (it != queue.begin() && (it - 1)->time > time) --it;
+    queue.insert(it, { time, event });
+}
+
+void Release(ENetPacket* packet) {
+    if (--packet->referenceCount == 0) enet_packet_destroy(packet);
+}
+
+} // namespace
+
+extern "C" {
+
+int enet_initialize(void) { return 0; }
+void enet_deinitialize(void) {}
+enet_uint32 enet_time_get(void) { return wire.now; }
+
+int enet_address_set_host(ENetAddress* address, const char*) {
+    address->host = 0;
+    return 0;
+}
+
+ENetHost* enet_host_create(const ENetAddress* address, size_t, size_t, enet_uint32, enet_uint32) {
+    ENetHost* host = new ENetHost();
+    host->address.port = address ? address->port : 0;
+    wire.hosts.push_back(host);
+    return host;
+}
+
+void enet_host_destroy(ENetHost* host) {
+    for (Delivery& delivery : wire.queues[host]) {
+        if (delivery.event.packet) enet_packet_destroy(delivery.event.packet);
+    }
+    wire.queues.erase(host);
+    for (ENetHost*& known : wire.hosts) {
+        if (known == host) known = nullptr;
+    }
+    delete host;
+}
+
+ENetPeer* enet_host_connect(ENetHost* host, const ENetAddress* address, size_t, enet_uint32 data) {
+    ENetHost* server = nullptr;
+    for (ENetHost* known : wire.hosts) {
+        if (known && known != host && known->address.port == address->port) server = known;
+    }
+    if (!server) return nullptr;
+
+    ENetPeer* local = new ENetPeer();
+    ENetPeer* remote = new ENetPeer();
+    wire.routes[local] = { server, remote };
+    wire.routes[remote] = { host, local };
+
+    ENetEvent event = {};
+    event.type = ENET_EVENT_TYPE_CONNECT;
+    event.peer = remote;
+    event.data = data;
+    Push(server, wire.now + wire.delayMs, event);
+    event.peer = local;
+    Push(host, wire.now + 2 * wire.delayMs, event);
+    return local;
+}
+
+int enet_host_service(ENetHost* host, ENetEvent* event, enet_uint32) {
+    while (!wire.inFlight.empty() && wire.inFlight.begin()->first <= wire.now) {
+        ENetPacket* packet = wire.inFlight.begin()->second;
+        wire.inFlight.erase(wire.inFlight.begin());
+        Release(packet);
+    }
+
+    std::deque<Delivery>& queue = wire.queues[host];
+    if (queue.empty() || queue.front().time > wire.now) return 0;
+    *event = queue.front().event;
+    queue.pop_front();
+    return 1;
+}
+
+void enet_host_flush(ENetHost*) {}
+
+ENetPacket* enet_packet_create(const void* data, size_t length, enet_uint32 flags) {
+    ENetPacket* packet = new ENetPacket();
+    if (flags & ENET_PACKET_FLAG_NO_ALLOCATE) packet->data = (enet_uint8*)data;
+    else {
+        packet->data = (enet_uint8*)malloc(length ? length : 1);
+        if (data) memcpy(packet->data, data, length);
+    }
+    packet->dataLength = length;
+    packet->flags = flags;
+    return packet;
+}
+
+void enet_packet_destroy(ENetPacket* packet) {
+    if (packet->freeCallback) packet->freeCallback(packet);
+    if (!(packet->flags & ENET_PACKET_FLAG_NO_ALLOCATE)) free(packet->data);
+    delete packet;
+}
+
+int enet_peer_send(ENetPeer* peer, enet_uint8 channel, ENetPacket* packet) {
+    auto route = wire.routes.find(peer);
+    if (route == wire.routes.end()) return -1;
+    ENetHost* target = route->second.first;
+    wire.packets++;
+    packet->referenceCount++;
+
+    // Reliable: every loss costs a resend timeout (doubling), and nothing overtakes an earlier one.
+    // Unreliable: simply lost.
+    std::uniform_real_distribution<double> chance(0, 1);
+    uint32_t time = wire.now + wire.delayMs;
+    if (packet->flags & ENET_PACKET_FLAG_RELIABLE) {
+        uint32_t timeout = 2 * wire.delayMs + 50;
+        while (chance(wire.rng) < wire.loss) {
+            wire.lost++;
+            time += timeout;
+            timeout *= 2;
+        }
+        time = std::max(time, wire.lastReliable[target]);
+        wire.lastReliable[target] = time;
+    }
+    else if (chance(wire.rng) < wire.loss) {
+        wire.lost++;
+        wire.inFlight.insert({ wire.now, packet });
+        return 0;
+    }
+    wire.inFlight.insert({ time, packet });
+
+    ENetEvent event = {};
+    event.type = ENET_EVENT_TYPE_RECEIVE;
+    event.peer = route->second.second;
+    event.channelID = channel;
+    event.packet = enet_packet_create(packet->data, packet->dataLength, 0);
+    Push(target, time, event);
+    return 0;
+}
+
+void enet_peer_disconnect(ENetPeer* peer, enet_uint32) {
+    auto route = wire.routes.find(peer);
+    if (route == wire.routes.end()) return;
+    ENetHost* target = route->second.first;
+    ENetEvent event = {};
+    event.type = ENET_EVENT_TYPE_DISCONNECT;
+    event.peer = route->second.second;
+    Push(target, std::max(wire.now + wire.delayMs, wire.lastReliable[target]), event);
+}
+
+} // extern "C"
+
+// --- MATCH ---
+
+static const int PORT = 7777;
+
+// One side of the match: network endpoint, both boards, and the bot playing the local one
+struct Endpoint {
+    NetworkManager net;
+    Simulation local, remote;
+    bool paused = false;
+    float countdown = 0;
+    AIPlayer bot{ 1, 8, 1 };
+    uint8_t round = 0;
+    std::unordered_map<uint64_t, uint64_t> history;  // Checksum of the local board per (round, tick)
+};
+
+static uint64_t HistoryKey(uint8_t round, uint64_t tick) {
+    return ((uint64_t)round << 40) | tick;
+}
+
+// What can go wrong during a scenario
+enum Event { EVENT_NONE, EVENT_CORRUPT, EVENT_RESTART };
+
+struct Scenario {
+    const char* name;
+    uint32_t delayMs;
+    double loss;
+    Event event;
+};
+
+struct Result {
+    uint64_t checks = 0;
+    uint64_t mismatches = 0;
+    uint64_t lateMismatches = 0;   // More than SETTLE_FRAMES after the event
+    uint64_t desyncs = 0;
+    uint64_t rollbacks = 0;
+    uint32_t deepest = 0;
+    uint64_t checksumsVerified = 0;
+    int rounds = 0;
+};
+
+// Frames a corrupted board may stay out of sync (detection at the next sampled checksum, then a resync round trip)
+static const int SETTLE_FRAMES = 180;
+
+// Compares the copy 'to' keeps of the board of 'from' with the real one, once no rollback can change it
+static bool CheckSync(const Endpoint& from, const Endpoint& to, Result& result) {
+    const RollbackSession& session = to.net.GetRollback();
+    if (to.round == 0 || session.GetFrame() > session.GetConfirmedFrame()) return true;
+    auto real = from.history.find(HistoryKey(to.round, to.remote.GetTick()));
+    if (real == from.history.end()) return true;
+    result.checks++;
+    return real->second == to.remote.GetChecksum();
+}
+
+static Result Run(const Scenario& scenario, int seconds, uint32_t seed) {
+    wire = Link();
+    wire.delayMs = scenario.delayMs;
+    wire.loss = scenario.loss;
+    wire.rng.seed(seed);
+
+    Result result;
+    {
+        Endpoint host, client;
+        host.net.StartServer(PORT);
+        client.net.StartClient("127.0.0.1", PORT);
+        host.bot.ticksPerMove = 3;
+        client.bot.ticksPerMove = 3;
+        Endpoint* endpoints[2] = { &host, &client };
+
+        const double DT = 1.0 / 60.0;
+        const int frames = seconds * 60;
+        const int eventFrame = frames / 3;
+        for (int frame = 0; frame < frames; frame++) {
+            wire.now = (uint32_t)(frame * 1000 / 60);
+
+            for (Endpoint* e : endpoints) {
+                e->net.Update(e->local, e->remote, e->paused, e->countdown);
+
+                // Requests are always accepted, as a player would (see main.cpp)
+                if (e->net.restartRequestReceived) {
+                    e->net.SendResponse(PACKET_RESTART_RES, true);
+                    e->net.restartRequestReceived = false;
+                }
+                if (e->net.GetRound() != e->round) {
+                    e->round = e->net.GetRound();
+                    e->bot.Reset();
+                }
+            }
+
+            // The event, on the host's side
+            if (frame == eventFrame && scenario.event == EVENT_CORRUPT) {
+                Snapshot state;
+                host.local.Save(state);
+                state.bag.Reset(seed + 777);
+                state.score += 100;
+                host.local.Restore(state);
+            }
+            if (frame == eventFrame && scenario.event == EVENT_RESTART) host.net.SendRequest(PACKET_RESTART_REQ);
+
+            for (Endpoint* e : endpoints) {
+                if (e->countdown > 0) e->countdown -= (float)DT;
+                bool stopped = e->countdown > 0 || e->net.restartRequestPending;
+                InputState input = stopped ? InputState{} : e->bot.GetInput(e->local);
+                e->net.StepLocal(e->local, input, DT, stopped);
+                if (e->round > 0) e->history[HistoryKey(e->round, e->local.GetTick())] = e->local.GetChecksum();
+                e->net.Flush(DT);
+            }
+
+            for (int side = 0; side < 2; side++) {
+                if (CheckSync(*endpoints[side], *endpoints[1 - side], result)) continue;
+                result.mismatches++;
+                if (scenario.event != EVENT_CORRUPT || frame > eventFrame + SETTLE_FRAMES) result.lateMismatches++;
+            }
+        }
+
+        for (Endpoint* e : endpoints) {
+            const RollbackStats& stats = e->net.GetRollback().GetStats();
+            result.desyncs += stats.desyncs;
+            result.rollbacks += stats.rollbacks;
+            result.checksumsVerified += stats.checksumsVerified;
+            if (stats.maxDepth > result.deepest) result.deepest = stats.maxDepth;
+        }
+        result.rounds = std::min(host.round, client.round);
+
+        // Packets still on the wire go back to their batchers before those are gone
+        for (auto& sent : wire.inFlight) Release(sent.second);
+        wire.inFlight.clear();
+        client.net.Stop();
+        host.net.Stop();
+    }
+
+    for (auto& queue : wire.queues) {
+        for (Delivery& delivery : queue.second) {
+            if (delivery.event.packet) enet_packet_destroy(delivery.event.packet);
+        }
+    }
+    for (auto& route : wire.routes) delete route.first;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 40;
+    uint32_t seed = argc > 2 ? (uint32_t)atoi(argv[2]) : 1;
+
+    const Scenario scenarios[] = {
+        { "perfect link",           0,   0.00, EVENT_NONE },
+        { "lan",                    16,  0.01, EVENT_NONE },
+        { "internet",               50,  0.05, EVENT_NONE },
+        { "bad internet",           150, 0.10, EVENT_NONE },
+        { "heavy loss",             100, 0.25, EVENT_NONE },
+        { "45 frames of delay",     750, 0.05, EVENT_NONE },
+        { "corrupted board",        50,  0.05, EVENT_CORRUPT },
+        { "restart",                100, 0.05, EVENT_RESTART },
+    };
+
+    bool allPassed = true;
+    for (const Scenario& scenario : scenarios) {
+        Result r = Run(scenario, seconds, seed);
+
+        // A corrupted board must be seen, caught and repaired; anything else must never diverge
+        bool passed = r.checks > 0 && r.lateMismatches == 0;
+        if (scenario.event == EVENT_CORRUPT) passed = passed && r.mismatches > 0 && r.desyncs > 0;
+        else passed = passed && r.mismatches == 0 && r.desyncs == 0;
+        if (scenario.event == EVENT_RESTART) passed = passed && r.rounds == 2;
+        allPassed = allPassed && passed;
+
+        printf("%-20s %4u ms %3.0f%% loss | %6llu checks, %4llu mismatches (%llu late) | desyncs %llu | checksums %4llu | rollbacks %5llu, deepest %2u | rounds %d | %s\n",
+               scenario.name, scenario.delayMs, scenario.loss * 100, (unsigned long long)r.checks,
+               (unsigned long long)r.mismatches, (unsigned long long)r.lateMismatches, (unsigned long long)r.desyncs,
+               (unsigned long long)r.checksumsVerified, (unsigned long long)r.rollbacks, r.deepest, r.rounds,
+               passed ? "ok" : "FAILED");
+    }
+
+    printf("%s\n", allPassed ? "ALL PASSED" : "FAILURES");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file spectate.cpp
+ * @brief Headless spectator: watches a match on a MatchServer (a shard's port
+ * when sharded), simulating both boards from the server's input stream, and
+ * prints their scores once a second. Stops when the match ends or on Ctrl+C.
+ *
+ * Usage: spectate [host] [port] [matchId]
+ *   matchId: id of the match on that server (default 0: its oldest running match).
+ */
+
+#include "../include/spectator.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+static volatile std::sig_atomic_t running = 1;
+
+static void OnSignal(int) {
+    running = 0;
+}
+
+int main(int argc, char** argv) {
+    const char* hostName = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? atoi(argv[2]) : 1234;
+    uint64_t matchId = argc > 3 ? strtoull(argv[3], nullptr, 10) : 0;
+
+    Spectator spectator;
+    if (!spectator.Start(hostName, port, matchId)) {
+        fprintf(stderr, "Could not connect to %s:%d\n", hostName, port);
+        return 1;
+    }
+
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    auto lastReport = std::chrono::steady_clock::now();
+    while (running && !spectator.HasEnded()) {
+        spectator.Update(5);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport < std::chrono::seconds(1) || !spectator.IsWatching()) continue;
+        lastReport = now;
+
+        const Simulation& a = spectator.GetBoard(0);
+        const Simulation& b = spectator.GetBoard(1);
+        printf("round %u | frame %u: score %d, lines %d%s | frame %u: score %d, lines %d%s\n", spectator.GetRoundCount(),
+               spectator.GetFrame(0), a.score, a.totalLinesCleared, a.gameOver ? " (game over)" : "",
+               spectator.GetFrame(1), b.score, b.totalLinesCleared, b.gameOver ? " (game over)" : "");
+    }
+
+    printf(spectator.HasEnded() ? "Match over\n" : "Stopped\n");
+    spectator.Stop();
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file wire_check.cpp
+ * @brief Checks that WireProtocol rejects board states a remote peer could use
+ * to corrupt memory. Encodes a real game in progress as a PACKET_STATE (which
+ * must decode back to the same board), then tampered copies of it: the falling
+ * piece moved off the grid or into the stack, piece ids outside 1-7 in the bag
+ * queue, a bag mask or queue longer than the bag can hold. Each must fail both
+ * DecodeNext and DecodeState. Also checks that messages with the header of an
+ * earlier protocol version (raw structs, the 2-bit version layout) are dropped.
+ * Prints one line per case and exits with 1 if any was accepted.
+ *
+ * Usage: wire_check
+ */
+
+#include "../include/sim_runner.hpp"
+#include "../include/wire_protocol.hpp"
+#include <cstdio>
+#include <functional>
+
+// --- ENCODED STATE ---
+
+static size_t SkipVarint(const std::vector<uint8_t>& data, size_t pos) {
+    while (data[pos] & 0x80) pos++;
+    return pos + 1;
+}
+
+// Offsets of the fields a test tampers with, in a PACKET_STATE built by EncodeState
+struct Layout {
+    size_t row;          // Zigzag varint (one byte for rows on the grid)
+    size_t bagMask;
+    size_t queueCount;
+};
+
+static Layout Locate(const std::vector<uint8_t>& message) {
+    size_t pos = SkipVarint(message, 1);                              // Header, frame
+    for (int i = 0; i < 4; i++) pos = SkipVarint(message, pos);       // Tick, score, level, lines
+    pos = SkipVarint(message, pos + 1) + 2;                           // Game over, gravity, piece id, rotation
+    Layout layout;
+    layout.row = pos;
+    pos = SkipVarint(message, SkipVarint(message, pos)) + 1 + 8;      // Row, column, next id, generator
+    layout.bagMask = pos;
+    layout.queueCount = pos + 1;
+    return layout;
+}
+
+// --- CHECKS ---
+
+// True if neither DecodeNext nor DecodeState accepts 'message'
+static bool Rejected(const std::vector<uint8_t>& message) {
+    NetMessage decoded;
+    size_t pos = 0;
+    if (WireProtocol::DecodeNext(message.data(), message.size(), pos, decoded)) return false;
+
+    // DecodeState is the last line of defence for a message that skipped DecodeNext
+    decoded = WireProtocol::Make(PACKET_STATE);
+    decoded.state = message.data() + SkipVarint(message, 1);
+    decoded.stateSize = message.size() - SkipVarint(message, 1);
+    Snapshot state;
+    return !WireProtocol::DecodeState(decoded, state);
+}
+
+int main() {
+    // A game in progress, with pieces on the stack and a filled preview queue
+    Simulation game;
+    game.Reset(7);
+    uint64_t policyState = 1;
+    for (int t = 0; t < 200 && !game.gameOver; t++) game.Tick(SimRunner::RandomPolicy(game, policyState));
+    Snapshot original;
+    game.Save(original);
+    original.bag.Peek(3);
+    game.Restore(original);
+
+    bool passed = true;
+
+    // 1. The real state goes through unchanged
+    std::vector<uint8_t> message;
+    WireProtocol::EncodeState(1234, original, message);
+    NetMessage decoded;
+    Snapshot state;
+    game.Save(state);
+    size_t pos = 0;
+    bool accepted = WireProtocol::DecodeNext(message.data(), message.size(), pos, decoded) &&
+                    WireProtocol::DecodeState(decoded, state);
+    Simulation copy;
+    if (accepted) copy.Restore(state);
+    bool same = accepted && copy.GetChecksum() == game.GetChecksum();
+    printf("%-28s %s\n", "valid state", same ? "accepted" : "REJECTED");
+    passed = passed && same;
+
+    // 2. Tampered boards, encoded as they are
+    const std::pair<const char*, std::function<void(Snapshot&)>> boards[] = {
+        { "piece 100 rows down", [](Snapshot& s) { s.currentBlock.Move(100, 0); } },
+        { "piece inside the stack", [](Snapshot& s) {
+              for (int r = 0; r < Grid::NUM_ROWS; r++) {
+                  for (int c = 1; c < Grid::NUM_COLUMNS; c++) s.grid.SetCell(r, c, 1);
+              }
+          } },
+    };
+    for (const auto& test : boards) {
+        Snapshot tampered = original;
+        test.second(tampered);
+        std::vector<uint8_t> bytes;
+        WireProtocol::EncodeState(1234, tampered, bytes);
+        bool rejected = Rejected(bytes);
+        printf("%-28s %s\n", test.first, rejected ? "rejected" : "ACCEPTED");
+        passed = passed && rejected;
+    }
+
+    // 3. Tampered fields, patched into the encoded state
+    const Layout layout = Locate(message);
+    const std::pair<const char*, std::function<void(std::vector<uint8_t>&)>> fields[] = {
+        { "piece below the floor", [&](std::vector<uint8_t>& m) { m[layout.row] = 2 * Grid::NUM_ROWS - 2; } },
+        { "piece above the ceiling", [&](std::vector<uint8_t>& m) { m[layout.row] = 2 * 4 - 1; } },
+        { "bag mask 0x80", [&](std::vector<uint8_t>& m) { m[layout.bagMask] |= 0x80; } },
+        { "queue longer than preview", [&](std::vector<uint8_t>& m) {
+              m.insert(m.begin() + layout.queueCount + 1, PieceBag::MAX_PREVIEW + 1 - m[layout.queueCount], 1);
+              m[layout.queueCount] = PieceBag::MAX_PREVIEW + 1;
+          } },
+        { "queue piece id 0", [&](std::vector<uint8_t>& m) { m[layout.queueCount + 1] = 0; } },
+        { "queue piece id 8", [&](std::vector<uint8_t>& m) { m[layout.queueCount + 1] = 8; } },
+    };
+    for (const auto& test : fields) {
+        std::vector<uint8_t> bytes = message;
+        test.second(bytes);
+        bool rejected = Rejected(bytes);
+        printf("%-28s %s\n", test.first, rejected ? "rejected" : "ACCEPTED");
+        passed = passed && rejected;
+    }
+
+    // 4. Headers of earlier versions, on a message that is only a header in every version
+    int oldAccepted = 0;
+    for (int version = 0; version < 4; version++) {
+        uint8_t header = (uint8_t)(PACKET_PAUSE_REQ | (version << 6));
+        if (WireProtocol::Decode(&header, 1, decoded)) oldAccepted++;
+    }
+    for (int type = 0; type <= 10; type++) {
+        uint8_t raw[16] = { (uint8_t)type };
+        if (WireProtocol::Decode(raw, sizeof(raw), decoded)) oldAccepted++;
+    }
+    printf("%-28s %s\n", "earlier protocol versions", oldAccepted == 0 ? "rejected" : "ACCEPTED");
+    passed = passed && oldAccepted == 0;
+
+    printf("%s\n", passed ? "ALL PASSED" : "FAILURES");
+    return passed ? 0 : 1;
+}